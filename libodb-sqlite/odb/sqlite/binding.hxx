@@ -21,10 +21,20 @@ namespace odb
     public:
       typedef sqlite::bind bind_type;
 
-      binding (): bind (0), count (0), version (0) {}
+      binding ()
+          : bind (0), count (0), version (0),
+            batch (0), skip (0), status (0), prefetch (0) {}
 
       binding (bind_type* b, std::size_t n)
-          : bind (b), count (n), version (0)
+          : bind (b), count (n), version (0),
+            batch (0), skip (0), status (0), prefetch (0)
+      {
+      }
+
+      binding (bind_type* b, std::size_t n,
+               std::size_t bt, std::size_t s, unsigned long long* st)
+          : bind (b), count (n), version (0),
+            batch (bt), skip (s), status (st), prefetch (0)
       {
       }
 
@@ -32,6 +42,20 @@ namespace odb
       std::size_t count;
       std::size_t version;
 
+      // Bulk operation support. The bind array describes the first image
+      // in an array of batch images that are skip bytes apart. The status
+      // array receives the per-image execution result.
+      //
+      std::size_t batch;
+      std::size_t skip;
+      unsigned long long* status; // Batch status array.
+
+      // Parameter images for a keyed select (see select_statement::key()).
+      // If not NULL, then the statement is executed for the first batch
+      // images of this binding rather than for the first image of ours.
+      //
+      const binding* prefetch;
+
     private:
       binding (const binding&);
       binding& operator= (const binding&);
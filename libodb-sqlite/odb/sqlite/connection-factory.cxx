@@ -2,7 +2,9 @@
 // license   : GNU GPL v2; see accompanying LICENSE file
 
 #include <cassert>
+#include <functional> // std::less
 
+#include <odb/details/tls.hxx>
 #include <odb/details/lock.hxx>
 
 #include <odb/sqlite/database.hxx>
@@ -298,6 +300,509 @@ namespace odb
       return static_cast<connection_pool_factory&> (c->factory_).release (c);
     }
 
+#ifdef ODB_CXX11
+    //
+    // concurrent_connection_pool_factory
+    //
+
+    // The slot (of any pool) this thread last returned a connection to.
+    //
+    static ODB_TLS_POINTER (void) concurrent_pool_slot;
+
+    concurrent_connection_pool_factory::
+    concurrent_connection_pool_factory (size_t max_connections,
+                                        size_t min_connections)
+        : max_ (max_connections),
+          min_ (min_connections),
+          extra_flags_ (0),
+          slots_ (new slot[max_connections]),
+          waiters_ (0),
+          next_ (0),
+          cond_ (mutex_),
+          exhausted_ (0),
+          wait_time_ (0),
+          max_wait_time_ (0)
+    {
+      assert (max_connections != 0 && max_connections >= min_connections);
+    }
+
+    concurrent_connection_pool_factory::pooled_connection_ptr
+    concurrent_connection_pool_factory::
+    create ()
+    {
+      return pooled_connection_ptr (
+        new (shared) pooled_connection (*this, extra_flags_));
+    }
+
+    concurrent_connection_pool_factory::
+    ~concurrent_connection_pool_factory ()
+    {
+      // Wait for all the connections currently in use to return to the
+      // pool and then free them.
+      //
+      {
+        lock l (mutex_);
+        waiters_++;
+
+        for (size_t n (0);;)
+        {
+          for (size_t i (0); i != max_; ++i)
+          {
+            if (pooled_connection* c = slots_[i].connection.exchange (0))
+            {
+              pooled_connection_ptr p (c);
+              n++;
+            }
+          }
+
+          if (n == connections_.size ())
+            break;
+
+          cond_.wait (l);
+        }
+
+        waiters_--;
+      }
+
+      delete[] slots_;
+    }
+
+    size_t concurrent_connection_pool_factory::
+    affinity_slot () const
+    {
+      const slot* s (static_cast<const slot*> (tls_get (concurrent_pool_slot)));
+
+      less<const slot*> lt;
+      return !lt (s, slots_) && lt (s, slots_ + max_)
+        ? static_cast<size_t> (s - slots_)
+        : max_;
+    }
+
+    concurrent_connection_pool_factory::pooled_connection*
+    concurrent_connection_pool_factory::
+    take (size_t i, bool& affinity)
+    {
+      pooled_connection* c;
+
+      if (i != max_ && (c = slots_[i].connection.exchange (0)) != 0)
+      {
+        affinity = true;
+        return c;
+      }
+
+      affinity = false;
+
+      // Spread the threads that don't have a slot yet over the slots.
+      //
+      if (i == max_)
+        i = next_++ % max_;
+
+      for (size_t n (0); n != max_; ++n, i = (i + 1) % max_)
+      {
+        if (slots_[i].connection.load () != 0 &&
+            (c = slots_[i].connection.exchange (0)) != 0)
+          return c;
+      }
+
+      return 0;
+    }
+
+    size_t concurrent_connection_pool_factory::
+    put (pooled_connection* c, size_t i)
+    {
+      if (i == max_)
+        i = 0;
+
+      // There is always a free slot since there are as many slots as
+      // there can be connections.
+      //
+      for (;; i = (i + 1) % max_)
+      {
+        pooled_connection* e (0);
+        if (slots_[i].connection.load (memory_order_relaxed) == 0 &&
+            slots_[i].connection.compare_exchange_strong (e, c))
+          return i;
+      }
+    }
+
+    connection_ptr concurrent_connection_pool_factory::
+    connect ()
+    {
+      size_t i (affinity_slot ());
+
+      bool a;
+      pooled_connection* c (take (i, a));
+
+      if (c == 0)
+      {
+        typedef chrono::steady_clock clock;
+        clock::time_point start (clock::now ());
+
+        lock l (mutex_);
+        waiters_++;
+
+        bool waited (false);
+        while ((c = take (i, a)) == 0)
+        {
+          // See if we can create a new one.
+          //
+          if (connections_.size () < max_)
+          {
+            c = create ().release ();
+            connections_.push_back (c);
+            break;
+          }
+
+          // Wait until someone releases a connection.
+          //
+          waited = true;
+          cond_.wait (l);
+        }
+
+        waiters_--;
+
+        chrono::nanoseconds d (clock::now () - start);
+
+        if (waited)
+          exhausted_++;
+
+        wait_time_ += d;
+
+        if (d > max_wait_time_)
+          max_wait_time_ = d;
+      }
+
+      // We are the only user of the connection so no need for atomic
+      // increments.
+      //
+      c->checkouts_.store (c->checkouts_.load (memory_order_relaxed) + 1,
+                           memory_order_relaxed);
+      if (a)
+        c->affinity_hits_.store (
+          c->affinity_hits_.load (memory_order_relaxed) + 1,
+          memory_order_relaxed);
+
+      c->callback_ = &c->cb_;
+      return connection_ptr (c);
+    }
+
+    void concurrent_connection_pool_factory::
+    database (database_type& db)
+    {
+      bool first (db_ == 0);
+
+      connection_factory::database (db);
+
+      if (!first)
+        return;
+
+      // Unless explicitly disabled, enable shared cache.
+      //
+#if SQLITE_VERSION_NUMBER >= 3006018 && defined(LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY)
+      if ((db_->flags () & SQLITE_OPEN_PRIVATECACHE) == 0)
+        extra_flags_ |= SQLITE_OPEN_SHAREDCACHE;
+#endif
+
+      if (min_ > 0)
+      {
+        lock l (mutex_);
+        connections_.reserve (min_);
+
+        for (size_t i (0); i < min_; ++i)
+        {
+          pooled_connection* c (create ().release ());
+          connections_.push_back (c);
+          slots_[i].connection = c;
+        }
+      }
+    }
+
+    bool concurrent_connection_pool_factory::
+    release (pooled_connection* c)
+    {
+      c->callback_ = 0;
+      c->recycle ();
+
+      size_t i (put (inc_ref (c), affinity_slot ()));
+      tls_set (concurrent_pool_slot, static_cast<void*> (slots_ + i));
+
+      if (waiters_ != 0)
+      {
+        lock l (mutex_);
+        cond_.signal ();
+      }
+
+      return false;
+    }
+
+    concurrent_connection_pool_factory::statistics
+    concurrent_connection_pool_factory::
+    stats ()
+    {
+      statistics r;
+
+      lock l (mutex_);
+
+      r.connections = connections_.size ();
+      r.idle = 0;
+      r.waiters = waiters_;
+      r.checkouts = 0;
+      r.affinity_hits = 0;
+      r.exhausted = exhausted_;
+      r.wait_time = wait_time_;
+      r.max_wait_time = max_wait_time_;
+
+      for (size_t i (0); i != connections_.size (); ++i)
+      {
+        const pooled_connection& c (*connections_[i]);
+        r.checkouts += c.checkouts_.load (memory_order_relaxed);
+        r.affinity_hits += c.affinity_hits_.load (memory_order_relaxed);
+      }
+
+      for (size_t i (0); i != max_; ++i)
+      {
+        if (slots_[i].connection.load (memory_order_relaxed) != 0)
+          r.idle++;
+      }
+
+      return r;
+    }
+
+    //
+    // concurrent_connection_pool_factory::pooled_connection
+    //
+
+    concurrent_connection_pool_factory::pooled_connection::
+    pooled_connection (concurrent_connection_pool_factory& f,
+                       int extra_flags)
+        : connection (f, extra_flags), checkouts_ (0), affinity_hits_ (0)
+    {
+      cb_.arg = this;
+      cb_.zero_counter = &zero_counter;
+    }
+
+    concurrent_connection_pool_factory::pooled_connection::
+    pooled_connection (concurrent_connection_pool_factory& f,
+                       sqlite3* handle)
+        : connection (f, handle), checkouts_ (0), affinity_hits_ (0)
+    {
+      cb_.arg = this;
+      cb_.zero_counter = &zero_counter;
+    }
+
+    bool concurrent_connection_pool_factory::pooled_connection::
+    zero_counter (void* arg)
+    {
+      pooled_connection* c (static_cast<pooled_connection*> (arg));
+      return static_cast<concurrent_connection_pool_factory&> (
+        c->factory_).release (c);
+    }
+#endif
+
+    //
+    // wal_connection_factory
+    //
+
+    wal_connection_factory::pooled_connection_ptr wal_connection_factory::
+    create_writer ()
+    {
+      return pooled_connection_ptr (
+        new (shared) pooled_connection (*this, extra_flags_));
+    }
+
+    wal_connection_factory::pooled_connection_ptr wal_connection_factory::
+    create_reader ()
+    {
+      pooled_connection_ptr c (
+        new (shared) pooled_connection (*this, extra_flags_));
+
+      // PRAGMA query_only was added in SQLite 3.8.0.
+      //
+#if SQLITE_VERSION_NUMBER >= 3008000
+      c->execute ("PRAGMA query_only=ON");
+#endif
+
+      return c;
+    }
+
+    wal_connection_factory::
+    ~wal_connection_factory ()
+    {
+      // Wait for all the connections currently in use to return to the
+      // factory.
+      //
+      lock l (mutex_);
+
+      while (writer_in_use_)
+      {
+        writer_waiters_++;
+        writer_cond_.wait (l);
+        writer_waiters_--;
+      }
+
+      while (readers_in_use_ != 0)
+      {
+        reader_waiters_++;
+        reader_cond_.wait (l);
+        reader_waiters_--;
+      }
+    }
+
+    connection_ptr wal_connection_factory::
+    connect ()
+    {
+      lock l (mutex_);
+
+      // Wait until the writer is released by the previous write
+      // transaction.
+      //
+      while (writer_in_use_)
+      {
+        writer_waiters_++;
+        writer_cond_.wait (l);
+        writer_waiters_--;
+      }
+
+      writer_->callback_ = &writer_->cb_;
+      writer_in_use_ = true;
+
+      connection_ptr r (writer_);
+      writer_.reset ();
+      return r;
+    }
+
+    connection_ptr wal_connection_factory::
+    connect_read ()
+    {
+      lock l (mutex_);
+
+      while (true)
+      {
+        // See if we have a spare connection.
+        //
+        if (readers_.size () != 0)
+        {
+          pooled_connection_ptr c (readers_.back ());
+          readers_.pop_back ();
+
+          c->callback_ = &c->cb_;
+          readers_in_use_++;
+          return c;
+        }
+
+        // See if we can create a new one.
+        //
+        if (max_ == 0 || readers_in_use_ < max_)
+        {
+          pooled_connection_ptr c (create_reader ());
+          c->reader_ = true;
+          c->callback_ = &c->cb_;
+          readers_in_use_++;
+          return c;
+        }
+
+        // Wait until someone releases a connection.
+        //
+        reader_waiters_++;
+        reader_cond_.wait (l);
+        reader_waiters_--;
+      }
+    }
+
+    void wal_connection_factory::
+    database (database_type& db)
+    {
+      bool first (db_ == 0);
+
+      connection_factory::database (db);
+
+      if (!first)
+        return;
+
+      // Switch the database to the WAL journal mode. This setting is
+      // persistent so the read connections will see it as well.
+      //
+      writer_ = create_writer ();
+      writer_->execute ("PRAGMA journal_mode=WAL");
+
+      if (min_ > 0)
+      {
+        readers_.reserve (min_);
+
+        for(size_t i (0); i < min_; ++i)
+        {
+          readers_.push_back (create_reader ());
+          readers_.back ()->reader_ = true;
+        }
+      }
+    }
+
+    bool wal_connection_factory::
+    release (pooled_connection* c)
+    {
+      c->callback_ = 0;
+
+      lock l (mutex_);
+
+      if (!c->reader_)
+      {
+        writer_.reset (inc_ref (c));
+        writer_->recycle ();
+        writer_in_use_ = false;
+
+        if (writer_waiters_ != 0)
+          writer_cond_.signal ();
+
+        return false;
+      }
+
+      // Determine if we need to keep or free this connection.
+      //
+      bool keep (reader_waiters_ != 0 ||
+                 min_ == 0 ||
+                 (readers_.size () + readers_in_use_ <= min_));
+
+      readers_in_use_--;
+
+      if (keep)
+      {
+        readers_.push_back (pooled_connection_ptr (inc_ref (c)));
+        readers_.back ()->recycle ();
+      }
+
+      if (reader_waiters_ != 0)
+        reader_cond_.signal ();
+
+      return !keep;
+    }
+
+    //
+    // wal_connection_factory::pooled_connection
+    //
+
+    wal_connection_factory::pooled_connection::
+    pooled_connection (wal_connection_factory& f, int extra_flags)
+        : connection (f, extra_flags), reader_ (false)
+    {
+      cb_.arg = this;
+      cb_.zero_counter = &zero_counter;
+    }
+
+    wal_connection_factory::pooled_connection::
+    pooled_connection (wal_connection_factory& f, sqlite3* handle)
+        : connection (f, handle), reader_ (false)
+    {
+      cb_.arg = this;
+      cb_.zero_counter = &zero_counter;
+    }
+
+    bool wal_connection_factory::pooled_connection::
+    zero_counter (void* arg)
+    {
+      pooled_connection* c (static_cast<pooled_connection*> (arg));
+      return static_cast<wal_connection_factory&> (c->factory_).release (c);
+    }
+
     //
     // default_attached_connection_factory
     //
@@ -10,10 +10,16 @@
 #include <cstddef> // std::size_t
 #include <cassert>
 
+#include <odb/details/config.hxx> // ODB_CXX11
 #include <odb/details/mutex.hxx>
 #include <odb/details/condition.hxx>
 #include <odb/details/shared-ptr.hxx>
 
+#ifdef ODB_CXX11
+#  include <atomic>
+#  include <chrono>
+#endif
+
 #include <odb/sqlite/version.hxx>
 #include <odb/sqlite/forward.hxx>
 #include <odb/sqlite/connection.hxx>
@@ -234,6 +240,292 @@ namespace odb
       details::condition cond_;
     };
 
+#ifdef ODB_CXX11
+    // Pool a number of connections with minimal contention between
+    // threads.
+    //
+    // Idle connections are kept in an array of slots that are emptied and
+    // filled with atomic operations so that, unless the pool is exhausted,
+    // getting and returning a connection does not lock a mutex. A thread
+    // also remembers the slot it last returned a connection to and first
+    // tries to get the connection back from this slot. As a result, a
+    // thread normally keeps getting the same connection (and its cache of
+    // prepared statements).
+    //
+    // Unlike connection_pool_factory, this pool has a fixed maximum number
+    // of connections and it never releases the connections it has created.
+    //
+    class LIBODB_SQLITE_EXPORT concurrent_connection_pool_factory:
+      public connection_factory
+    {
+    public:
+      // The max_connections argument specifies the maximum number of
+      // concurrent connections this pool will maintain and must not be 0.
+      // If all of the connections are in use, then connect() blocks until
+      // one is returned to the pool.
+      //
+      // The min_connections argument specifies the number of connections
+      // that should be created upfront.
+      //
+      concurrent_connection_pool_factory (std::size_t max_connections,
+                                          std::size_t min_connections = 0);
+
+      virtual connection_ptr
+      connect ();
+
+      virtual void
+      database (database_type&);
+
+      virtual
+      ~concurrent_connection_pool_factory ();
+
+      // Pool statistics. Note that the values are collected without
+      // stopping the threads that use the pool and so may be slightly
+      // inconsistent with each other.
+      //
+      struct statistics
+      {
+        std::size_t connections;   // Number of connections created.
+        std::size_t idle;          // Number of idle connections.
+        std::size_t waiters;       // Number of threads currently waiting.
+
+        std::size_t checkouts;     // Number of connections handed out.
+        std::size_t affinity_hits; // Number of times a thread got back the
+                                   // connection it used last.
+        std::size_t exhausted;     // Number of times connect() had to wait.
+
+        // Total and maximum time spent in connect() when no idle connection
+        // was available, that is, when it had to create a new connection
+        // or to wait for one to be returned.
+        //
+        std::chrono::nanoseconds wait_time;
+        std::chrono::nanoseconds max_wait_time;
+      };
+
+      statistics
+      stats ();
+
+    private:
+      concurrent_connection_pool_factory (
+        const concurrent_connection_pool_factory&);
+      concurrent_connection_pool_factory& operator= (
+        const concurrent_connection_pool_factory&);
+
+    protected:
+      class LIBODB_SQLITE_EXPORT pooled_connection: public connection
+      {
+      public:
+        pooled_connection (concurrent_connection_pool_factory&,
+                           int extra_flags = 0);
+        pooled_connection (concurrent_connection_pool_factory&, sqlite3*);
+
+      private:
+        static bool
+        zero_counter (void*);
+
+      private:
+        friend class concurrent_connection_pool_factory;
+        shared_base::refcount_callback cb_;
+
+        // Only modified by the thread that currently uses the connection.
+        //
+        std::atomic<std::size_t> checkouts_;
+        std::atomic<std::size_t> affinity_hits_;
+      };
+
+      friend class pooled_connection;
+
+      typedef details::shared_ptr<pooled_connection> pooled_connection_ptr;
+
+      // This function is called whenever the pool needs to create a new
+      // connection.
+      //
+      virtual pooled_connection_ptr
+      create ();
+
+    protected:
+      // Return true if the connection should be deleted, false otherwise.
+      //
+      bool
+      release (pooled_connection*);
+
+      // Take an idle connection, trying the specified slot first. Return
+      // NULL if there are none. Set affinity to true if the connection
+      // came from the specified slot.
+      //
+      pooled_connection*
+      take (std::size_t slot, bool& affinity);
+
+      // Place an idle connection into a free slot, trying the specified
+      // slot first. Return the slot used.
+      //
+      std::size_t
+      put (pooled_connection*, std::size_t slot);
+
+      // Return the slot this thread last returned a connection to or
+      // max_ if there is none.
+      //
+      std::size_t
+      affinity_slot () const;
+
+    protected:
+      const std::size_t max_;
+      const std::size_t min_;
+      int extra_flags_;
+
+      // Each slot occupies its own cache line to avoid false sharing.
+      //
+      struct slot
+      {
+        slot (): connection (0) {}
+
+        std::atomic<pooled_connection*> connection;
+        char pad[64 - sizeof (std::atomic<pooled_connection*>)];
+      };
+
+      slot* slots_; // Array of max_ slots.
+
+      std::atomic<std::size_t> waiters_; // Number of waiting threads.
+      std::atomic<std::size_t> next_;    // Next slot for new threads.
+
+      // The following members are protected by the mutex.
+      //
+      details::mutex mutex_;
+      details::condition cond_;
+
+      std::vector<pooled_connection*> connections_; // All created.
+      std::size_t exhausted_;
+      std::chrono::nanoseconds wait_time_;
+      std::chrono::nanoseconds max_wait_time_;
+    };
+#endif
+
+    // Use a single writer connection and a pool of reader connections with
+    // a database in the WAL journal mode.
+    //
+    // In the WAL mode readers do not block the writer and the writer does
+    // not block readers, but there can only be one writer at a time. So
+    // this factory hands out the writer connection to the immediate and
+    // exclusive transactions (connect()), serializing them in-process
+    // rather than letting them contend for the database lock, and pooled
+    // read-only connections to the deferred transactions (connect_read()).
+    // As a result, a transaction that modifies the database must be started
+    // with begin_immediate() or begin_exclusive().
+    //
+    // The shared cache mode is not used by this factory and the database
+    // should be a file (the WAL mode is not supported for in-memory
+    // databases).
+    //
+    class LIBODB_SQLITE_EXPORT wal_connection_factory:
+      public connection_factory
+    {
+    public:
+      // The max_readers argument specifies the maximum number of concurrent
+      // read connections this factory will maintain. If this value is 0
+      // then the factory will create a new read connection every time all
+      // of the existing ones are in use.
+      //
+      // The min_readers argument specifies the minimum number of read
+      // connections that should be maintained by the factory. If the number
+      // of read connections exceeds this number and there are no threads
+      // waiting for one, then the factory will release the excess
+      // connections. If this value is 0 then the factory will maintain all
+      // the read connections that were ever created.
+      //
+      wal_connection_factory (std::size_t max_readers = 0,
+                              std::size_t min_readers = 0)
+          : max_ (max_readers),
+            min_ (min_readers),
+            extra_flags_ (0),
+            writer_in_use_ (false),
+            writer_waiters_ (0),
+            readers_in_use_ (0),
+            reader_waiters_ (0),
+            writer_cond_ (mutex_),
+            reader_cond_ (mutex_)
+      {
+        // max_readers == 0 means unlimited.
+        //
+        assert (max_readers == 0 || max_readers >= min_readers);
+      }
+
+      // Return the writer connection, blocking until it becomes available.
+      //
+      virtual connection_ptr
+      connect ();
+
+      // Return a read-only connection.
+      //
+      virtual connection_ptr
+      connect_read ();
+
+      virtual void
+      database (database_type&);
+
+      virtual
+      ~wal_connection_factory ();
+
+    private:
+      wal_connection_factory (const wal_connection_factory&);
+      wal_connection_factory& operator= (const wal_connection_factory&);
+
+    protected:
+      class LIBODB_SQLITE_EXPORT pooled_connection: public connection
+      {
+      public:
+        pooled_connection (wal_connection_factory&, int extra_flags = 0);
+        pooled_connection (wal_connection_factory&, sqlite3*);
+
+      private:
+        static bool
+        zero_counter (void*);
+
+      private:
+        friend class wal_connection_factory;
+        shared_base::refcount_callback cb_;
+        bool reader_;
+      };
+
+      friend class pooled_connection;
+
+      typedef details::shared_ptr<pooled_connection> pooled_connection_ptr;
+      typedef std::vector<pooled_connection_ptr> connections;
+
+      // These functions are called whenever the factory needs to create
+      // the writer connection and a new read connection, respectively.
+      // The default implementation of create_reader() makes the connection
+      // read-only with PRAGMA query_only (if supported by SQLite).
+      //
+      virtual pooled_connection_ptr
+      create_writer ();
+
+      virtual pooled_connection_ptr
+      create_reader ();
+
+    protected:
+      // Return true if the connection should be deleted, false otherwise.
+      //
+      bool
+      release (pooled_connection*);
+
+    protected:
+      const std::size_t max_;
+      const std::size_t min_;
+      int extra_flags_;
+
+      pooled_connection_ptr writer_;
+      bool writer_in_use_;
+      std::size_t writer_waiters_;
+
+      std::size_t readers_in_use_;
+      std::size_t reader_waiters_;
+      connections readers_; // Idle read connections.
+
+      details::mutex mutex_;
+      details::condition writer_cond_;
+      details::condition reader_cond_;
+    };
+
     class LIBODB_SQLITE_EXPORT default_attached_connection_factory:
       public attached_connection_factory
     {
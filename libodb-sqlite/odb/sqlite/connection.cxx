@@ -3,6 +3,7 @@
 
 #include <new>    // std::bad_alloc
 #include <string>
+#include <sstream>
 #include <cassert>
 
 #include <odb/details/lock.hxx>
@@ -23,6 +24,9 @@ using namespace std;
 extern "C" void
 odb_sqlite_connection_unlock_callback (void**, int);
 
+extern "C" int
+odb_sqlite_connection_busy_handler (void*, int);
+
 namespace odb
 {
   using namespace details;
@@ -113,6 +117,76 @@ namespace odb
         db.foreign_keys () ? 22 : 23);
       st.execute ();
 
+      // Retry on SQLITE_BUSY according to the database's retry policy.
+      //
+      busy_wait_ = 0;
+      sqlite3_busy_handler (
+        handle_, &odb_sqlite_connection_busy_handler, this);
+
+      // Apply the database's PRAGMA profile. Note that the page size has
+      // to be set before switching to the WAL mode in order to have any
+      // effect.
+      //
+      {
+        static const char* const journal_modes[] = {
+          0, "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+
+        static const char* const synchronous_levels[] = {
+          0, "OFF", "NORMAL", "FULL", "EXTRA"};
+
+        static const char* const temp_stores[] = {0, "FILE", "MEMORY"};
+
+        const pragma_profile& pp (db.pragma_profile ());
+
+        if (pp.page_size != 0)
+        {
+          ostringstream os;
+          os << "PRAGMA page_size=" << pp.page_size;
+          generic_statement (*this, os.str ()).execute ();
+        }
+
+        if (pp.journal_mode != pragma_profile::journal_mode_default)
+          generic_statement (
+            *this,
+            string ("PRAGMA journal_mode=") +
+            journal_modes[pp.journal_mode]).execute ();
+
+        if (pp.synchronous != pragma_profile::synchronous_default)
+          generic_statement (
+            *this,
+            string ("PRAGMA synchronous=") +
+            synchronous_levels[pp.synchronous]).execute ();
+
+        if (pp.temp_store != pragma_profile::temp_store_default)
+          generic_statement (
+            *this,
+            string ("PRAGMA temp_store=") +
+            temp_stores[pp.temp_store]).execute ();
+
+        if (pp.cache_size != 0)
+        {
+          ostringstream os;
+          os << "PRAGMA cache_size=" << pp.cache_size;
+          generic_statement (*this, os.str ()).execute ();
+        }
+
+#if SQLITE_VERSION_NUMBER >= 3007017
+        if (pp.mmap_size != -1)
+        {
+          ostringstream os;
+          os << "PRAGMA mmap_size=" << pp.mmap_size;
+          generic_statement (*this, os.str ()).execute ();
+        }
+#endif
+
+        if (pp.wal_autocheckpoint != -1)
+        {
+          ostringstream os;
+          os << "PRAGMA wal_autocheckpoint=" << pp.wal_autocheckpoint;
+          generic_statement (*this, os.str ()).execute ();
+        }
+      }
+
       // String lengths include '\0', as per the SQLite manual suggestion.
       //
       begin_.reset (new (shared) generic_statement (*this, "BEGIN", 6));
@@ -230,6 +304,19 @@ namespace odb
       }
     }
 
+    int
+    connection_busy_handler (void* arg, int count)
+    {
+      connection* c (static_cast<connection*> (arg));
+
+      // SQLite starts counting from 0 for each operation.
+      //
+      if (count == 0)
+        c->busy_wait_ = 0;
+
+      return c->database ().busy_wait (count, c->busy_wait_) ? 1 : 0;
+    }
+
     void connection::
     wait ()
     {
@@ -287,6 +374,12 @@ namespace odb
       db_ = &db;
     }
 
+    connection_ptr connection_factory::
+    connect_read ()
+    {
+      return connect ();
+    }
+
     void connection_factory::
     attach_database (const connection_ptr& conn,
                      const std::string& name,
@@ -308,3 +401,9 @@ odb_sqlite_connection_unlock_callback (void** args, int n)
 {
   odb::sqlite::connection_unlock_callback (args, n);
 }
+
+extern "C" int
+odb_sqlite_connection_busy_handler (void* arg, int count)
+{
+  return odb::sqlite::connection_busy_handler (arg, count);
+}
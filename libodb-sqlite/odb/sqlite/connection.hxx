@@ -255,6 +255,14 @@ namespace odb
       friend void
       connection_unlock_callback (void**, int);
 
+      // Busy handler machinery (see retry_policy).
+      //
+    private:
+      unsigned int busy_wait_; // Time spent waiting for the current lock.
+
+      friend int
+      connection_busy_handler (void*, int);
+
     private:
       friend class statement;        // statement_translator_
       friend class transaction_impl; // invalidate_results()
@@ -282,6 +290,14 @@ namespace odb
       virtual connection_ptr
       connect () = 0;
 
+      // Return a connection for reading, such as for a deferred
+      // transaction. Factories that maintain separate connections for
+      // reading can override this function. The default implementation
+      // calls connect().
+      //
+      virtual connection_ptr
+      connect_read ();
+
       virtual
       ~connection_factory ();
 
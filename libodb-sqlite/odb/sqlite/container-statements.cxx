@@ -0,0 +1,69 @@
+// file      : odb/sqlite/container-statements.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/container-statements.hxx>
+
+using namespace std;
+
+namespace odb
+{
+  namespace sqlite
+  {
+    void
+    bind_key (const binding& b, vector<char>& k)
+    {
+      for (size_t i (0); i != b.count; ++i)
+      {
+        const bind& x (b.bind[i]);
+
+        if (x.buffer == 0 || x.type == bind::stream)
+          continue;
+
+        char n (x.is_null != 0 && *x.is_null ? 1 : 0);
+        k.push_back (n);
+
+        if (n != 0)
+          continue;
+
+        const char* p (0);
+        size_t s (0);
+
+        switch (x.type)
+        {
+        case bind::integer:
+          {
+            p = static_cast<const char*> (x.buffer);
+            s = sizeof (long long);
+            break;
+          }
+        case bind::real:
+          {
+            p = static_cast<const char*> (x.buffer);
+            s = sizeof (double);
+            break;
+          }
+        case bind::text:
+        case bind::text16:
+        case bind::blob:
+        case bind::text_view:
+        case bind::blob_view:
+          {
+            // Prefix the value with its size so that the values of several
+            // columns cannot run together.
+            //
+            p = *static_cast<const char* const*> (x.buffer);
+            s = *x.size;
+
+            const char* sp (reinterpret_cast<const char*> (&s));
+            k.insert (k.end (), sp, sp + sizeof (s));
+            break;
+          }
+        case bind::stream:
+          break;
+        }
+
+        k.insert (k.end (), p, p + s);
+      }
+    }
+  }
+}
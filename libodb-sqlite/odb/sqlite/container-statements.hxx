@@ -6,6 +6,7 @@
 
 #include <odb/pre.hxx>
 
+#include <vector>
 #include <cstddef> // std::size_t
 
 #include <odb/forward.hxx>
@@ -23,6 +24,13 @@ namespace odb
   {
     class connection;
 
+    // Append the parameter values (including their NULL flags) to the
+    // key. Used to identify the object that owns a container (see
+    // smart_ordered_functions::owner()).
+    //
+    LIBODB_SQLITE_EXPORT void
+    bind_key (const binding&, std::vector<char>&);
+
     // Template argument is the generated abstract container traits type.
     // That is, it doesn't need to provide column counts and statements.
     //
@@ -134,6 +142,9 @@ namespace odb
       select_statement_type&
       select_statement ()
       {
+        if (batch_active_)
+          return *batch_select_;
+
         if (select_ == 0)
           select_.reset (
             new (details::shared) select_statement_type (
@@ -147,6 +158,17 @@ namespace odb
         return *select_;
       }
 
+      // Execute and return the statement for loading the container of the
+      // object in the id image. If the id binding refers to the ids of
+      // several objects (see binding::prefetch), then the elements for all
+      // these objects are loaded with a single execution of the batch
+      // statement and, until the next call to this function, the select
+      // statement returns the batch statement positioned on the rows of
+      // the current object. Otherwise, the select statement is executed.
+      //
+      select_statement_type&
+      load_statement (const char* batch_text);
+
       delete_statement_type&
       delete_statement ()
       {
@@ -187,6 +209,12 @@ namespace odb
       details::shared_ptr<insert_statement_type> insert_;
       details::shared_ptr<select_statement_type> select_;
       details::shared_ptr<delete_statement_type> delete_;
+
+      // Batch loading.
+      //
+      details::shared_ptr<select_statement_type> batch_select_;
+      std::size_t batch_version_;
+      bool batch_active_;
     };
 
     template <typename T>
@@ -293,6 +321,10 @@ namespace odb
         return *update_;
       }
 
+    private:
+      static void
+      owner (std::vector<char>&, void*);
+
     protected:
       cond_image_type cond_image_;
       std::size_t cond_image_version_;
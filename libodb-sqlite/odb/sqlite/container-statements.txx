@@ -1,8 +1,9 @@
 // file      : odb/sqlite/container-statements.txx
 // license   : GNU GPL v2; see accompanying LICENSE file
 
-#include <cstddef> // std::size_t
-#include <cstring> // std::memset
+#include <cstddef>  // std::size_t
+#include <cstring>  // std::memset
+#include <typeinfo>
 
 namespace odb
 {
@@ -27,6 +28,55 @@ namespace odb
       data_image_.version = 0;
       data_image_version_ = 0;
       data_id_binding_version_ = 0;
+
+      batch_version_ = 0;
+      batch_active_ = false;
+    }
+
+    template <typename T>
+    typename container_statements<T>::select_statement_type&
+    container_statements<T>::
+    load_statement (const char* batch_text)
+    {
+      batch_active_ = false;
+
+      if (const binding* pb = id_binding_.prefetch)
+      {
+        if (batch_select_ == 0)
+        {
+          batch_select_.reset (
+            new (details::shared) select_statement_type (
+              conn_,
+              batch_text,
+              false, // Not versioned.
+              false, // Don't optimize.
+              id_binding_,
+              select_image_binding_));
+
+          batch_select_->key (id_binding_.count);
+        }
+
+        // Re-execute the batch statement if the prefetched ids have
+        // changed. We need to cache the result since the rows will be
+        // consumed over several calls.
+        //
+        if (batch_version_ != pb->version)
+        {
+          batch_select_->execute ();
+          batch_select_->cache ();
+          batch_version_ = pb->version;
+        }
+
+        if (batch_select_->select_key ())
+        {
+          batch_active_ = true;
+          return *batch_select_;
+        }
+      }
+
+      select_statement_type& st (select_statement ());
+      st.execute ();
+      return st;
     }
 
     // smart_container_statements
@@ -39,6 +89,7 @@ namespace odb
           update_image_binding_ (0, 0) // Initialized by impl.
     {
       this->functions_.update_ = &traits::update;
+      this->functions_.owner_ = &owner;
 
       cond_image_.version = 0;
       cond_image_version_ = 0;
@@ -49,6 +100,23 @@ namespace odb
       update_data_image_version_ = 0;
     }
 
+    template <typename T>
+    void smart_container_statements<T>::
+    owner (std::vector<char>& k, void* d)
+    {
+      container_statements<T>& sts (
+        *static_cast<container_statements<T>*> (d));
+
+      // The container traits type identifies both the object type and
+      // the member. It is followed by the object id.
+      //
+      const std::type_info* t (&typeid (traits));
+      const char* p (reinterpret_cast<const char*> (&t));
+      k.insert (k.end (), p, p + sizeof (t));
+
+      bind_key (sts.id_binding (), k);
+    }
+
     // container_statements_impl
     //
     template <typename T>
@@ -7,9 +7,12 @@
 
 #include <sqlite3.h>
 
+#include <ctime>   // std::time, std::clock
 #include <cassert>
 #include <sstream>
 
+#include <odb/details/lock.hxx>
+
 #include <odb/sqlite/database.hxx>
 #include <odb/sqlite/connection.hxx>
 #include <odb/sqlite/connection-factory.hxx>
@@ -38,12 +41,17 @@ namespace odb
               int flags,
               bool foreign_keys,
               const string& vfs,
-              transfer_ptr<connection_factory> factory)
+              transfer_ptr<connection_factory> factory,
+              const sqlite::pragma_profile& pragmas)
         : odb::database (id_sqlite),
           name_ (name),
           flags_ (flags),
           foreign_keys_ (foreign_keys),
           vfs_ (vfs),
+          result_prefetch_ (0),
+          pragma_profile_ (pragmas),
+          retry_stats_ (),
+          retry_seed_ (0),
           factory_ (factory.transfer ())
     {
       if (!factory_)
@@ -58,11 +66,16 @@ namespace odb
               int flags,
               bool foreign_keys,
               const string& vfs,
-              transfer_ptr<connection_factory> factory)
+              transfer_ptr<connection_factory> factory,
+              const sqlite::pragma_profile& pragmas)
         : odb::database (id_sqlite),
           flags_ (flags),
           foreign_keys_ (foreign_keys),
           vfs_ (vfs),
+          result_prefetch_ (0),
+          pragma_profile_ (pragmas),
+          retry_stats_ (),
+          retry_seed_ (0),
           factory_ (factory.transfer ())
     {
       // Convert UTF-16 name to UTF-8 using the WideCharToMultiByte() Win32
@@ -109,6 +122,30 @@ namespace odb
     }
 #endif
 
+    // Command line values of the pragma_profile enumerations in the
+    // enumerator order (the first enumerator is the default).
+    //
+    static const char* const journal_mode_values[] = {
+      "", "delete", "truncate", "persist", "memory", "wal", "off", 0};
+
+    static const char* const synchronous_values[] = {
+      "", "off", "normal", "full", "extra", 0};
+
+    static const char* const temp_store_values[] = {"", "file", "memory", 0};
+
+    template <typename E>
+    static E
+    parse_pragma (const char* o, const string& v, const char* const* values)
+    {
+      for (size_t i (1); values[i] != 0; ++i)
+      {
+        if (v == values[i])
+          return static_cast<E> (i);
+      }
+
+      throw details::cli::invalid_value (o, v);
+    }
+
     database::
     database (int& argc,
               char* argv[],
@@ -116,11 +153,16 @@ namespace odb
               int flags,
               bool foreign_keys,
               const string& vfs,
-              transfer_ptr<connection_factory> factory)
+              transfer_ptr<connection_factory> factory,
+              const sqlite::pragma_profile& pragmas)
         : odb::database (id_sqlite),
           flags_ (flags),
           foreign_keys_ (foreign_keys),
           vfs_ (vfs),
+          result_prefetch_ (0),
+          pragma_profile_ (pragmas),
+          retry_stats_ (),
+          retry_seed_ (0),
           factory_ (factory.transfer ())
     {
       using namespace details;
@@ -137,6 +179,33 @@ namespace odb
 
         if (ops.read_only ())
           flags_ = (flags_ & ~SQLITE_OPEN_READWRITE) | SQLITE_OPEN_READONLY;
+
+        typedef sqlite::pragma_profile profile;
+        profile& pp (pragma_profile_);
+
+        if (!ops.journal_mode ().empty ())
+          pp.journal_mode = parse_pragma<profile::journal_mode_type> (
+            "--journal-mode", ops.journal_mode (), journal_mode_values);
+
+        if (!ops.synchronous ().empty ())
+          pp.synchronous = parse_pragma<profile::synchronous_type> (
+            "--synchronous", ops.synchronous (), synchronous_values);
+
+        if (!ops.temp_store ().empty ())
+          pp.temp_store = parse_pragma<profile::temp_store_type> (
+            "--temp-store", ops.temp_store (), temp_store_values);
+
+        if (ops.cache_size () != 0)
+          pp.cache_size = ops.cache_size ();
+
+        if (ops.mmap_size () != -1)
+          pp.mmap_size = ops.mmap_size ();
+
+        if (ops.page_size () != 0)
+          pp.page_size = ops.page_size ();
+
+        if (ops.wal_autocheckpoint () != -1)
+          pp.wal_autocheckpoint = ops.wal_autocheckpoint ();
       }
       catch (const cli::exception& e)
       {
@@ -160,6 +229,9 @@ namespace odb
           name_ (name),
           schema_ (schema),
           flags_ (0),
+          result_prefetch_ (0),
+          retry_stats_ (),
+          retry_seed_ (0),
           factory_ (factory.transfer ())
     {
       assert (!schema_.empty ());
@@ -170,6 +242,9 @@ namespace odb
 
       tracer_ = db.tracer_;
       foreign_keys_ = db.foreign_keys_;
+      result_prefetch_ = db.result_prefetch_;
+      pragma_profile_ = db.pragma_profile_;
+      retry_policy_ = db.retry_policy_;
 
       if (!factory_)
         factory_.reset (new default_attached_connection_factory (
@@ -202,6 +277,104 @@ namespace odb
       return new transaction_impl (*this, transaction_impl::exclusive);
     }
 
+    connection_ptr database::
+    read_connection ()
+    {
+      return factory_->connect_read ();
+    }
+
+    retry_statistics database::
+    retry_stats ()
+    {
+      details::lock l (retry_mutex_);
+      return retry_stats_;
+    }
+
+    unsigned int database::
+    retry_delay (unsigned int count)
+    {
+      const sqlite::retry_policy& p (retry_policy_);
+
+      unsigned int r (p.initial_delay != 0 ? p.initial_delay : 1);
+      for (; count != 0 && r < p.max_delay; --count)
+        r *= 2;
+
+      if (r > p.max_delay)
+        r = p.max_delay;
+
+      if (p.jitter && r > 1)
+      {
+        // Seed with something that differs between processes that started
+        // contending at the same time.
+        //
+        if (retry_seed_ == 0)
+          retry_seed_ = static_cast<unsigned int> (
+            time (0) ^ clock () ^ reinterpret_cast<size_t> (this)) | 1;
+
+        // Xorshift.
+        //
+        retry_seed_ ^= retry_seed_ << 13;
+        retry_seed_ ^= retry_seed_ >> 17;
+        retry_seed_ ^= retry_seed_ << 5;
+
+        r = r / 2 + retry_seed_ % (r - r / 2 + 1);
+      }
+
+      return r;
+    }
+
+    bool database::
+    busy_wait (int count, unsigned int& wait_time)
+    {
+      unsigned int t (retry_policy_.busy_timeout);
+      unsigned int d;
+
+      {
+        details::lock l (retry_mutex_);
+
+        if (wait_time >= t)
+        {
+          if (t != 0)
+            retry_stats_.busy_timeouts++;
+
+          return false;
+        }
+
+        d = retry_delay (static_cast<unsigned int> (count));
+
+        if (d > t - wait_time)
+          d = t - wait_time;
+
+        retry_stats_.busy_retries++;
+        retry_stats_.wait_time += d;
+      }
+
+      sqlite3_sleep (static_cast<int> (d));
+      wait_time += d;
+      return true;
+    }
+
+    bool database::
+    retry_wait (unsigned short count)
+    {
+      unsigned int d;
+
+      {
+        details::lock l (retry_mutex_);
+
+        if (count >= retry_policy_.max_retries)
+          return false;
+
+        d = retry_delay (count);
+
+        retry_stats_.transaction_retries++;
+        retry_stats_.wait_time += d;
+      }
+
+      sqlite3_sleep (static_cast<int> (d));
+      return true;
+    }
+
     odb::connection* database::
     connection_ ()
     {
@@ -229,9 +402,10 @@ namespace odb
 
       // Bind parameters and results.
       //
+      const char* pbuf[1] = {name.c_str ()};
       size_t psize[1] = {name.size ()};
       bind pbind[1] = {{bind::text,
-                        const_cast<char*> (name.c_str ()),
+                        &pbuf[0],
                         &psize[0],
                         0, 0, 0}};
       binding param (pbind, 1);
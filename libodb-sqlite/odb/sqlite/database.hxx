@@ -9,10 +9,12 @@
 #include <sqlite3.h>
 
 #include <string>
-#include <iosfwd> // std::ostream
+#include <cstddef> // std::size_t
+#include <iosfwd>  // std::ostream
 
 #include <odb/database.hxx>
 #include <odb/details/config.hxx> // ODB_CXX11
+#include <odb/details/mutex.hxx>
 #include <odb/details/unique-ptr.hxx>
 #include <odb/details/transfer-ptr.hxx>
 
@@ -41,6 +43,128 @@ namespace odb
   {
     class transaction_impl;
 
+    // Handling of the contention for the database lock, normally between
+    // processes (contention between connections sharing the cache within
+    // a process is handled with the unlock notifications).
+    //
+    struct retry_policy
+    {
+      // Maximum time in milliseconds to keep retrying an operation that
+      // cannot acquire the database lock (SQLITE_BUSY) before giving up
+      // with odb::timeout. The 0 value disables retrying.
+      //
+      unsigned int busy_timeout;
+
+      // Initial and maximum delay in milliseconds between retries. The
+      // delay doubles after every retry until it reaches the maximum.
+      //
+      unsigned int initial_delay;
+      unsigned int max_delay;
+
+      // If true, then use a random delay between half and the full value
+      // so that the contending processes don't retry in lockstep.
+      //
+      bool jitter;
+
+      // Maximum number of times database::transact() re-executes a
+      // transaction that failed with a recoverable exception.
+      //
+      unsigned short max_retries;
+
+      explicit
+      retry_policy (unsigned int busy_timeout_ = 0,
+                    unsigned short max_retries_ = 5)
+          : busy_timeout (busy_timeout_),
+            initial_delay (1),
+            max_delay (100),
+            jitter (true),
+            max_retries (max_retries_)
+      {
+      }
+    };
+
+    struct retry_statistics
+    {
+      std::size_t busy_retries;        // Operations retried on SQLITE_BUSY.
+      std::size_t busy_timeouts;       // Operations that ran out of time.
+      std::size_t transaction_retries; // Transactions re-executed.
+
+      // Total time in milliseconds spent waiting between retries.
+      //
+      unsigned long long wait_time;
+    };
+
+    // PRAGMA settings that are applied to every connection when it is
+    // created. The default values leave the corresponding SQLite defaults
+    // unchanged. See the SQLite PRAGMA documentation for details on each
+    // setting.
+    //
+    struct pragma_profile
+    {
+      enum journal_mode_type
+      {
+        journal_mode_default,
+        journal_mode_delete,
+        journal_mode_truncate,
+        journal_mode_persist,
+        journal_mode_memory,
+        journal_mode_wal,
+        journal_mode_off
+      };
+
+      enum synchronous_type
+      {
+        synchronous_default,
+        synchronous_off,
+        synchronous_normal,
+        synchronous_full,
+        synchronous_extra
+      };
+
+      enum temp_store_type
+      {
+        temp_store_default,
+        temp_store_file,
+        temp_store_memory
+      };
+
+      journal_mode_type journal_mode;
+      synchronous_type synchronous;
+      temp_store_type temp_store;
+
+      // Page cache size in pages if positive and in KiB if negative. The 0
+      // value leaves the default.
+      //
+      int cache_size;
+
+      // Maximum number of bytes of the database file to memory-map with 0
+      // disabling memory-mapped I/O. The -1 value leaves the default.
+      // Requires SQLite 3.7.17 or later and is ignored otherwise.
+      //
+      long long mmap_size;
+
+      // Page size in bytes. Only has effect if set before the database
+      // file is created. The 0 value leaves the default.
+      //
+      unsigned int page_size;
+
+      // WAL auto-checkpoint threshold in pages with 0 disabling automatic
+      // checkpoints. The -1 value leaves the default.
+      //
+      int wal_autocheckpoint;
+
+      pragma_profile ()
+          : journal_mode (journal_mode_default),
+            synchronous (synchronous_default),
+            temp_store (temp_store_default),
+            cache_size (0),
+            mmap_size (-1),
+            page_size (0),
+            wal_autocheckpoint (-1)
+      {
+      }
+    };
+
     class LIBODB_SQLITE_EXPORT database: public odb::database
     {
     public:
@@ -49,7 +173,8 @@ namespace odb
                 bool foreign_keys = true,
                 const std::string& vfs = "",
                 details::transfer_ptr<connection_factory> =
-                  details::transfer_ptr<connection_factory> ());
+                  details::transfer_ptr<connection_factory> (),
+                const sqlite::pragma_profile& = sqlite::pragma_profile ());
 
 #ifdef _WIN32
       database (const std::wstring& name,
@@ -57,7 +182,8 @@ namespace odb
                 bool foreign_keys = true,
                 const std::string& vfs = "",
                 details::transfer_ptr<connection_factory> =
-                  details::transfer_ptr<connection_factory> ());
+                  details::transfer_ptr<connection_factory> (),
+                const sqlite::pragma_profile& = sqlite::pragma_profile ());
 #endif
 
       // Extract the database parameters from the command line. The
@@ -66,13 +192,20 @@ namespace odb
       // --database
       // --create
       // --read-only
+      // --journal-mode
+      // --synchronous
+      // --cache-size
+      // --mmap-size
+      // --page-size
+      // --temp-store
+      // --wal-autocheckpoint
       // --options-file
       //
       // For more information, see the output of the print_usage() function
       // below. If erase is true, the above options are removed from the argv
       // array and the argc count is updated accordingly. The command line
-      // options override the flags passed as an argument. This constructor
-      // may throw the cli_exception exception.
+      // options override the flags and PRAGMA settings passed as arguments.
+      // This constructor may throw the cli_exception exception.
       //
       database (int& argc,
                 char* argv[],
@@ -81,7 +214,8 @@ namespace odb
                 bool foreign_keys = true,
                 const std::string& vfs = "",
                 details::transfer_ptr<connection_factory> =
-                  details::transfer_ptr<connection_factory> ());
+                  details::transfer_ptr<connection_factory> (),
+                const sqlite::pragma_profile& = sqlite::pragma_profile ());
 
       // Attach to the specified connection a database with the specified name
       // as the specified schema. Good understanding of SQLite ATTACH/DETACH
@@ -196,6 +330,57 @@ namespace odb
         return vfs_;
       }
 
+      // Query result prefetching. If not 0, then the rows of query results
+      // are fetched on a helper thread into a ring buffer of this many rows
+      // while the application processes earlier rows. Note that this only
+      // works if the database is opened with SQLITE_OPEN_FULLMUTEX (see
+      // select_statement::prefetch() for details) and is ignored otherwise.
+      // Note also that in this mode the helper thread fetches rows ahead
+      // which means it can be wasteful if the iteration is stopped early.
+      //
+      std::size_t
+      result_prefetch () const
+      {
+        return result_prefetch_;
+      }
+
+      void
+      result_prefetch (std::size_t rows)
+      {
+        result_prefetch_ = rows;
+      }
+
+      // PRAGMA settings applied to every new connection.
+      //
+      const sqlite::pragma_profile&
+      pragma_profile () const
+      {
+        return pragma_profile_;
+      }
+
+      // Contention handling policy. The policy is used by all the
+      // connections of this database, including the existing ones, and
+      // should normally be set before the database is used. Note that a
+      // busy handler set directly on the connection handle overrides the
+      // policy's busy_timeout.
+      //
+      const sqlite::retry_policy&
+      retry_policy () const
+      {
+        return retry_policy_;
+      }
+
+      void
+      retry_policy (const sqlite::retry_policy& p)
+      {
+        retry_policy_ = p;
+      }
+
+      // Retry statistics accumulated since the database was created.
+      //
+      retry_statistics
+      retry_stats ();
+
       // Object persistence API.
       //
     public:
@@ -234,6 +419,13 @@ namespace odb
       typename object_traits<T>::id_type
       persist (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Bulk persist. Can be a range of references or pointers (including
+      // smart pointers) to objects.
+      //
+      template <typename I>
+      void
+      persist (I begin, I end, bool continue_failed = true);
+
       // Load an object. Throw object_not_persistent if not found.
       //
       template <typename T>
@@ -290,6 +482,15 @@ namespace odb
       bool
       find (const typename object_traits<T>::id_type& id, T& object);
 
+      // Load several objects by id with a small number of statements. The
+      // ids that are not in the session are looked up in chunks with the
+      // WHERE id IN (?, ...) condition (see odb::database::load() for
+      // details).
+      //
+      template <typename T, typename I, typename O>
+      std::size_t
+      load (I ids_begin, I ids_end, O out);
+
       // Update the state of a modified objects.
       //
       template <typename T>
@@ -320,6 +521,13 @@ namespace odb
       void
       update (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Bulk update. Can be a range of references or pointers (including
+      // smart pointers) to objects.
+      //
+      template <typename I>
+      void
+      update (I begin, I end, bool continue_failed = true);
+
       // Update a section of an object. Throws the section_not_loaded
       // exception if the section is not loaded. Note also that this
       // function does not clear the changed flag if it is set.
@@ -328,6 +536,23 @@ namespace odb
       void
       update (const T& object, const section&);
 
+      // Persist the object if there is no object with the same id in the
+      // database and update it otherwise using INSERT ... ON CONFLICT DO
+      // UPDATE (requires SQLite 3.24.0 or later). Throw object_changed if
+      // the object has optimistic concurrency and its version does not
+      // match the one in the database.
+      //
+      template <typename T>
+      void
+      upsert (T& object);
+
+      // Bulk upsert. Can be a range of references or pointers (including
+      // smart pointers) to objects.
+      //
+      template <typename I>
+      void
+      upsert (I begin, I end, bool continue_failed = true);
+
       // Make the object transient. Throw object_not_persistent if not
       // found.
       //
@@ -363,6 +588,19 @@ namespace odb
       void
       erase (const typename object_traits<T>::pointer_type& obj_ptr);
 
+      // Bulk erase.
+      //
+      template <typename T, typename I>
+      void
+      erase (I id_begin, I id_end, bool continue_failed = true);
+
+      // Can be a range of references or pointers (including smart pointers)
+      // to objects.
+      //
+      template <typename I>
+      void
+      erase (I obj_begin, I obj_end, bool continue_failed = true);
+
       // Erase multiple objects matching a query predicate.
       //
       template <typename T>
@@ -503,6 +741,28 @@ namespace odb
       connection_ptr
       connection ();
 
+      // Return a connection for reading. Unless the connection factory
+      // maintains separate connections for reading (for example,
+      // wal_connection_factory), this is the same as connection().
+      //
+      connection_ptr
+      read_connection ();
+
+      // Execute the function object (called without arguments) in a
+      // transaction, committing it if the function object returns
+      // normally. If the transaction fails with a recoverable exception
+      // (odb::timeout, odb::deadlock, etc), then re-execute it, waiting
+      // between attempts as specified by the retry policy, and rethrow the
+      // exception once retry_policy().max_retries is reached. Any other
+      // exception rolls the transaction back and is rethrown immediately.
+      //
+      // Note that since the function object may be called multiple times,
+      // it should not have side effects outside of the transaction.
+      //
+      template <typename F>
+      void
+      transact (F, transaction_impl::lock = transaction_impl::deferred);
+
       // SQL statement tracing.
       //
     public:
@@ -541,6 +801,30 @@ namespace odb
       virtual odb::connection*
       connection_ ();
 
+    private:
+      friend int
+      connection_busy_handler (void*, int); // busy_wait()
+
+      // Called by the connection's busy handler with the number of times
+      // it was called for the same operation and the time (in
+      // milliseconds) already spent waiting. Return true and update the
+      // waiting time if the operation should be retried.
+      //
+      bool
+      busy_wait (int count, unsigned int& wait_time);
+
+      // Called by transact(). Return true if the transaction should be
+      // re-executed.
+      //
+      bool
+      retry_wait (unsigned short count);
+
+      // Return the delay before the specified retry. Should be called with
+      // the retry mutex locked.
+      //
+      unsigned int
+      retry_delay (unsigned int count);
+
     private:
       friend class transaction_impl; // factory_
 
@@ -551,6 +835,14 @@ namespace odb
       int flags_;
       bool foreign_keys_;
       std::string vfs_;
+      std::size_t result_prefetch_;
+      sqlite::pragma_profile pragma_profile_;
+
+      sqlite::retry_policy retry_policy_;
+
+      details::mutex retry_mutex_;
+      retry_statistics retry_stats_;
+      unsigned int retry_seed_; // Jitter random number generator state.
 
       // Note: keep last so that all other database members are still valid
       // during factory's destruction.
@@ -18,6 +18,11 @@ namespace odb
           flags_ (db.flags_),
           foreign_keys_ (db.foreign_keys_),
           vfs_ (std::move (db.vfs_)),
+          result_prefetch_ (db.result_prefetch_),
+          pragma_profile_ (db.pragma_profile_),
+          retry_policy_ (db.retry_policy_),
+          retry_stats_ (db.retry_stats_),
+          retry_seed_ (db.retry_seed_),
           factory_ (std::move (db.factory_))
     {
       factory_->database (*this); // New database instance.
@@ -49,6 +54,31 @@ namespace odb
         static_cast<sqlite::connection*> (connection_ ()));
     }
 
+    template <typename F>
+    void database::
+    transact (F f, transaction_impl::lock l)
+    {
+      for (unsigned short retry_count (0); ; retry_count++)
+      {
+        try
+        {
+          transaction t (l == transaction_impl::immediate
+                         ? begin_immediate ()
+                         : l == transaction_impl::exclusive
+                         ? begin_exclusive ()
+                         : begin ());
+          f ();
+          t.commit ();
+          break;
+        }
+        catch (const recoverable&)
+        {
+          if (!retry_wait (retry_count))
+            throw;
+        }
+      }
+    }
+
     template <typename T>
     inline typename object_traits<T>::id_type database::
     persist (T& obj)
@@ -131,6 +161,13 @@ namespace odb
       return persist_<T, id_sqlite> (pobj);
     }
 
+    template <typename I>
+    inline void database::
+    persist (I b, I e, bool cont)
+    {
+      persist_<I, id_sqlite> (b, e, cont);
+    }
+
     template <typename T>
     inline typename object_traits<T>::pointer_type database::
     load (const typename object_traits<T>::id_type& id)
@@ -166,6 +203,13 @@ namespace odb
       return find_<T, id_sqlite> (id, obj);
     }
 
+    template <typename T, typename I, typename O>
+    inline std::size_t database::
+    load (I b, I e, O out)
+    {
+      return load_<T, id_sqlite> (b, e, out);
+    }
+
     template <typename T>
     inline void database::
     reload (T& obj)
@@ -292,6 +336,13 @@ namespace odb
       update_<T, id_sqlite> (pobj);
     }
 
+    template <typename I>
+    inline void database::
+    update (I b, I e, bool cont)
+    {
+      update_<I, id_sqlite> (b, e, cont);
+    }
+
     template <typename T>
     inline void database::
     update (const T& obj, const section& s)
@@ -299,6 +350,20 @@ namespace odb
       update_<T, id_sqlite> (obj, s);
     }
 
+    template <typename T>
+    inline void database::
+    upsert (T& obj)
+    {
+      upsert_<T, id_sqlite> (obj);
+    }
+
+    template <typename I>
+    inline void database::
+    upsert (I b, I e, bool cont)
+    {
+      upsert_<I, id_sqlite> (b, e, cont);
+    }
+
     template <typename T>
     inline void database::
     erase (const typename object_traits<T>::id_type& id)
@@ -381,6 +446,20 @@ namespace odb
       erase_<T, id_sqlite> (pobj);
     }
 
+    template <typename T, typename I>
+    inline void database::
+    erase (I idb, I ide, bool cont)
+    {
+      erase_id_<I, T, id_sqlite> (idb, ide, cont);
+    }
+
+    template <typename I>
+    inline void database::
+    erase (I ob, I oe, bool cont)
+    {
+      erase_object_<I, id_sqlite> (ob, oe, cont);
+    }
+
     template <typename T>
     inline unsigned long long database::
     erase_query ()
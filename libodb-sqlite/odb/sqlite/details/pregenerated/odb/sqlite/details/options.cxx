@@ -751,6 +751,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
       }
@@ -764,6 +771,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
         ::odb::sqlite::details::cli::argv_scanner s (argc, argv, erase);
@@ -780,6 +794,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
         ::odb::sqlite::details::cli::argv_scanner s (start, argc, argv, erase);
@@ -796,6 +817,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
         ::odb::sqlite::details::cli::argv_scanner s (argc, argv, erase);
@@ -814,6 +842,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
         ::odb::sqlite::details::cli::argv_scanner s (start, argc, argv, erase);
@@ -828,6 +863,13 @@ namespace odb
       : database_ (),
         create_ (),
         read_only_ (),
+        journal_mode_ (),
+        synchronous_ (),
+        cache_size_ (0),
+        mmap_size_ (-1),
+        page_size_ (0),
+        temp_store_ (),
+        wal_autocheckpoint_ (-1),
         options_file_ ()
       {
         _parse (s, opt, arg);
@@ -841,27 +883,59 @@ namespace odb
         if (p != ::odb::sqlite::details::cli::usage_para::none)
           os << ::std::endl;
 
-        os << "--database <filename> SQLite database file name. If the database file is not" << ::std::endl
-           << "                      specified then a private, temporary on-disk database will" << ::std::endl
-           << "                      be created. Use the :memory: special name to create a" << ::std::endl
-           << "                      private, temporary in-memory database." << ::std::endl;
+        os << "--database <filename>        SQLite database file name. If the database file is" << ::std::endl
+           << "                             not specified then a private, temporary on-disk" << ::std::endl
+           << "                             database will be created. Use the :memory: special" << ::std::endl
+           << "                             name to create a private, temporary in-memory" << ::std::endl
+           << "                             database." << ::std::endl;
 
         os << std::endl
-           << "--create              Create the SQLite database if it does not already exist." << ::std::endl
-           << "                      By default opening the database fails if it does not" << ::std::endl
-           << "                      already exist." << ::std::endl;
+           << "--create                     Create the SQLite database if it does not already" << ::std::endl
+           << "                             exist. By default opening the database fails if it" << ::std::endl
+           << "                             does not already exist." << ::std::endl;
 
         os << std::endl
-           << "--read-only           Open the SQLite database in read-only mode. By default" << ::std::endl
-           << "                      the database is opened for reading and writing if" << ::std::endl
-           << "                      possible, or reading only if the file is write-protected" << ::std::endl
-           << "                      by the operating system." << ::std::endl;
+           << "--read-only                  Open the SQLite database in read-only mode. By" << ::std::endl
+           << "                             default the database is opened for reading and" << ::std::endl
+           << "                             writing if possible, or reading only if the file" << ::std::endl
+           << "                             is write-protected by the operating system." << ::std::endl;
 
         os << std::endl
-           << "--options-file <file> Read additional options from <file>. Each option should" << ::std::endl
-           << "                      appear on a separate line optionally followed by space or" << ::std::endl
-           << "                      equal sign (=) and an option value. Empty lines and lines" << ::std::endl
-           << "                      starting with # are ignored." << ::std::endl;
+           << "--journal-mode <mode>        Set the journal mode of every connection. Valid" << ::std::endl
+           << "                             values are delete, truncate, persist, memory, wal," << ::std::endl
+           << "                             and off." << ::std::endl;
+
+        os << std::endl
+           << "--synchronous <level>        Set the synchronous flag of every connection." << ::std::endl
+           << "                             Valid values are off, normal, full, and extra." << ::std::endl;
+
+        os << std::endl
+           << "--cache-size <size>          Set the page cache size of every connection in" << ::std::endl
+           << "                             pages if positive or in KiB if negative." << ::std::endl;
+
+        os << std::endl
+           << "--mmap-size <bytes>          Set the maximum number of bytes of the database" << ::std::endl
+           << "                             file to memory-map with 0 disabling memory-mapped" << ::std::endl
+           << "                             I/O." << ::std::endl;
+
+        os << std::endl
+           << "--page-size <bytes>          Set the page size of the database. Only has effect" << ::std::endl
+           << "                             if the database file does not yet exist." << ::std::endl;
+
+        os << std::endl
+           << "--temp-store <store>         Set where temporary tables and indexes are stored." << ::std::endl
+           << "                             Valid values are file and memory." << ::std::endl;
+
+        os << std::endl
+           << "--wal-autocheckpoint <pages> Set the WAL auto-checkpoint threshold in pages" << ::std::endl
+           << "                             with 0 disabling automatic checkpoints." << ::std::endl;
+
+        os << std::endl
+           << "--options-file <file>        Read additional options from <file>. Each option" << ::std::endl
+           << "                             should appear on a separate line optionally" << ::std::endl
+           << "                             followed by space or equal sign (=) and an option" << ::std::endl
+           << "                             value. Empty lines and lines starting with # are" << ::std::endl
+           << "                             ignored." << ::std::endl;
 
         p = ::odb::sqlite::details::cli::usage_para::option;
 
@@ -884,6 +958,20 @@ namespace odb
           &::odb::sqlite::details::cli::thunk< options, &options::create_ >;
           _cli_options_map_["--read-only"] =
           &::odb::sqlite::details::cli::thunk< options, &options::read_only_ >;
+          _cli_options_map_["--journal-mode"] =
+          &::odb::sqlite::details::cli::thunk< options, std::string, &options::journal_mode_ >;
+          _cli_options_map_["--synchronous"] =
+          &::odb::sqlite::details::cli::thunk< options, std::string, &options::synchronous_ >;
+          _cli_options_map_["--cache-size"] =
+          &::odb::sqlite::details::cli::thunk< options, int, &options::cache_size_ >;
+          _cli_options_map_["--mmap-size"] =
+          &::odb::sqlite::details::cli::thunk< options, long long, &options::mmap_size_ >;
+          _cli_options_map_["--page-size"] =
+          &::odb::sqlite::details::cli::thunk< options, unsigned int, &options::page_size_ >;
+          _cli_options_map_["--temp-store"] =
+          &::odb::sqlite::details::cli::thunk< options, std::string, &options::temp_store_ >;
+          _cli_options_map_["--wal-autocheckpoint"] =
+          &::odb::sqlite::details::cli::thunk< options, int, &options::wal_autocheckpoint_ >;
           _cli_options_map_["--options-file"] =
           &::odb::sqlite::details::cli::thunk< options, std::string, &options::options_file_ >;
         }
@@ -489,6 +489,27 @@ namespace odb
         const bool&
         read_only () const;
 
+        const std::string&
+        journal_mode () const;
+
+        const std::string&
+        synchronous () const;
+
+        const int&
+        cache_size () const;
+
+        const long long&
+        mmap_size () const;
+
+        const unsigned int&
+        page_size () const;
+
+        const std::string&
+        temp_store () const;
+
+        const int&
+        wal_autocheckpoint () const;
+
         const std::string&
         options_file () const;
 
@@ -514,6 +535,13 @@ namespace odb
         std::string database_;
         bool create_;
         bool read_only_;
+        std::string journal_mode_;
+        std::string synchronous_;
+        int cache_size_;
+        long long mmap_size_;
+        unsigned int page_size_;
+        std::string temp_store_;
+        int wal_autocheckpoint_;
         std::string options_file_;
       };
     }
@@ -309,6 +309,48 @@ namespace odb
         return this->read_only_;
       }
 
+      inline const std::string& options::
+      journal_mode () const
+      {
+        return this->journal_mode_;
+      }
+
+      inline const std::string& options::
+      synchronous () const
+      {
+        return this->synchronous_;
+      }
+
+      inline const int& options::
+      cache_size () const
+      {
+        return this->cache_size_;
+      }
+
+      inline const long long& options::
+      mmap_size () const
+      {
+        return this->mmap_size_;
+      }
+
+      inline const unsigned int& options::
+      page_size () const
+      {
+        return this->page_size_;
+      }
+
+      inline const std::string& options::
+      temp_store () const
+      {
+        return this->temp_store_;
+      }
+
+      inline const int& options::
+      wal_autocheckpoint () const
+      {
+        return this->wal_autocheckpoint_;
+      }
+
       inline const std::string& options::
       options_file () const
       {
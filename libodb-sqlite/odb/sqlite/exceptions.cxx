@@ -27,6 +27,22 @@ namespace odb
       return new forced_rollback (*this);
     }
 
+    //
+    // no_shard_key
+    //
+
+    const char* no_shard_key::
+    what () const ODB_NOTHROW_NOEXCEPT
+    {
+      return "no shard key function for object type";
+    }
+
+    no_shard_key* no_shard_key::
+    clone () const
+    {
+      return new no_shard_key (*this);
+    }
+
     //
     // database_exception
     //
@@ -34,6 +34,18 @@ namespace odb
       clone () const;
     };
 
+    // This exception is thrown by sharded_database if no shard key
+    // function was specified for the object type.
+    //
+    struct LIBODB_SQLITE_EXPORT no_shard_key: odb::exception
+    {
+      virtual const char*
+      what () const ODB_NOTHROW_NOEXCEPT;
+
+      virtual no_shard_key*
+      clone () const;
+    };
+
     struct LIBODB_SQLITE_EXPORT database_exception: odb::database_exception
     {
       database_exception (int error,
@@ -72,6 +72,8 @@ namespace odb
     template <typename T>
     class polymorphic_derived_object_statements;
 
+    struct polymorphic_join_column;
+
     template <typename T>
     class no_id_object_statements;
 
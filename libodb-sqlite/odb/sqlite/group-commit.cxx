@@ -0,0 +1,239 @@
+// file      : odb/sqlite/group-commit.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/group-commit.hxx>
+
+#if defined(ODB_CXX11) && !defined(ODB_THREADS_NONE)
+
+#include <utility> // std::move
+
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/transaction.hxx>
+
+using namespace std;
+
+namespace odb
+{
+  namespace sqlite
+  {
+    group_commit::
+    group_commit (database_type& db,
+                  size_t max_batch,
+                  chrono::microseconds max_delay)
+        : db_ (db),
+          max_batch_ (max_batch),
+          max_delay_ (max_delay),
+          stop_ (false),
+          submitted_ (0),
+          completed_ (0)
+    {
+      stats_.units = 0;
+      stats_.failed = 0;
+      stats_.transactions = 0;
+      stats_.max_batch = 0;
+      stats_.queued = 0;
+
+      thread_ = thread (&group_commit::run, this);
+    }
+
+    group_commit::
+    ~group_commit ()
+    {
+      {
+        lock_guard<std::mutex> l (mutex_);
+        stop_ = true;
+      }
+
+      cond_.notify_one ();
+      thread_.join ();
+    }
+
+    future<void> group_commit::
+    submit (work_type w)
+    {
+      unit u;
+      u.work = move (w);
+      future<void> r (u.promise.get_future ());
+
+      {
+        lock_guard<std::mutex> l (mutex_);
+        queue_.push_back (move (u));
+        submitted_++;
+      }
+
+      cond_.notify_one ();
+      return r;
+    }
+
+    void group_commit::
+    submit (work_type w, callback_type c)
+    {
+      unit u;
+      u.work = move (w);
+      u.callback = move (c);
+
+      {
+        lock_guard<std::mutex> l (mutex_);
+        queue_.push_back (move (u));
+        submitted_++;
+      }
+
+      cond_.notify_one ();
+    }
+
+    void group_commit::
+    flush ()
+    {
+      unique_lock<std::mutex> l (mutex_);
+
+      for (size_t n (submitted_); completed_ < n; )
+        done_cond_.wait (l);
+    }
+
+    group_commit::statistics group_commit::
+    stats ()
+    {
+      lock_guard<std::mutex> l (mutex_);
+
+      statistics r (stats_);
+      r.queued = queue_.size ();
+      return r;
+    }
+
+    void group_commit::
+    run ()
+    {
+      for (;;)
+      {
+        vector<unit> us;
+
+        {
+          unique_lock<std::mutex> l (mutex_);
+
+          while (queue_.empty () && !stop_)
+            cond_.wait (l);
+
+          if (queue_.empty ())
+            break; // Stop requested and nothing left to commit.
+
+          if (max_delay_.count () != 0 && !stop_)
+          {
+            chrono::steady_clock::time_point d (
+              chrono::steady_clock::now () + max_delay_);
+
+            while (!stop_ && (max_batch_ == 0 || queue_.size () < max_batch_))
+            {
+              if (cond_.wait_until (l, d) == cv_status::timeout)
+                break;
+            }
+          }
+
+          size_t n (max_batch_ != 0 && max_batch_ < queue_.size ()
+                    ? max_batch_
+                    : queue_.size ());
+
+          us.reserve (n);
+          for (size_t i (0); i != n; ++i)
+          {
+            us.push_back (move (queue_.front ()));
+            queue_.pop_front ();
+          }
+        }
+
+        execute (us);
+      }
+    }
+
+    void group_commit::
+    execute (vector<unit>& us)
+    {
+      size_t n (us.size ());
+      vector<exception_ptr> es (n);
+
+      // Exception that caused the whole transaction to fail, if any. The
+      // units that have already failed keep their own exceptions.
+      //
+      exception_ptr te;
+
+      try
+      {
+        transaction t (db_.begin_immediate ());
+        connection& c (t.connection ());
+
+        for (size_t i (0); i != n; ++i)
+        {
+          c.execute ("SAVEPOINT odb_group_commit");
+
+          try
+          {
+            us[i].work (db_);
+          }
+          catch (...)
+          {
+            es[i] = current_exception ();
+          }
+
+          if (es[i])
+          {
+            // Reset any statements left active by the failed unit before
+            // rolling back its changes.
+            //
+            c.clear ();
+            c.execute ("ROLLBACK TO SAVEPOINT odb_group_commit");
+          }
+
+          c.execute ("RELEASE SAVEPOINT odb_group_commit");
+        }
+
+        t.commit ();
+      }
+      catch (...)
+      {
+        te = current_exception ();
+      }
+
+      size_t failed (0);
+      for (size_t i (0); i != n; ++i)
+      {
+        unit& u (us[i]);
+        exception_ptr e (es[i] ? es[i] : te);
+
+        if (e)
+          failed++;
+
+        if (u.callback)
+        {
+          try
+          {
+            u.callback (e);
+          }
+          catch (...)
+          {
+          }
+        }
+        else if (e)
+          u.promise.set_exception (e);
+        else
+          u.promise.set_value ();
+      }
+
+      {
+        lock_guard<std::mutex> l (mutex_);
+
+        completed_ += n;
+
+        stats_.units += n;
+        stats_.failed += failed;
+        stats_.transactions++;
+
+        if (n > stats_.max_batch)
+          stats_.max_batch = n;
+      }
+
+      done_cond_.notify_all ();
+    }
+  }
+}
+
+#endif // ODB_CXX11 && !ODB_THREADS_NONE
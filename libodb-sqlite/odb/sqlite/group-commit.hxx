@@ -0,0 +1,150 @@
+// file      : odb/sqlite/group-commit.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_GROUP_COMMIT_HXX
+#define ODB_SQLITE_GROUP_COMMIT_HXX
+
+#include <odb/pre.hxx>
+
+#include <odb/details/config.hxx> // ODB_CXX11, ODB_THREADS_NONE
+
+#if defined(ODB_CXX11) && !defined(ODB_THREADS_NONE)
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cstddef>   // std::size_t
+#include <exception> // std::exception_ptr
+#include <functional>
+#include <condition_variable>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/details/export.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Coalesce many small logical transactions into a single database
+    // transaction.
+    //
+    // A logical transaction (unit of work) is a function that is queued
+    // with submit() and later called by the committer thread inside an
+    // immediate transaction that is current for this thread (so the unit
+    // can use the database as usual, for example, call persist()). All the
+    // units that are queued while the committer thread is busy with the
+    // previous transaction are executed in the next one, each in its own
+    // savepoint, so that a unit that throws only rolls back its own
+    // changes. A unit becomes durable when the transaction it was executed
+    // in is committed, at which point its future becomes ready or its
+    // callback is called with a NULL exception pointer. If the unit throws
+    // or the transaction fails, then the future holds (or the callback is
+    // passed) the exception.
+    //
+    // Note that a unit must not start a transaction of its own, must not
+    // keep query results past its return, and must not call flush().
+    //
+    class LIBODB_SQLITE_EXPORT group_commit
+    {
+    public:
+      typedef sqlite::database database_type;
+
+      typedef std::function<void (database_type&)> work_type;
+      typedef std::function<void (std::exception_ptr)> callback_type;
+
+      // The max_batch argument specifies the maximum number of units
+      // executed in a single transaction with 0 meaning no limit.
+      //
+      // The max_delay argument specifies how long the committer thread
+      // waits for more units to be queued after getting the first one and
+      // before starting the transaction (unless max_batch units are already
+      // queued). Waiting trades latency for larger batches; with the default
+      // 0 value, batching only happens for units that are queued during the
+      // previous commit.
+      //
+      group_commit (database_type&,
+                    std::size_t max_batch = 0,
+                    std::chrono::microseconds max_delay =
+                      std::chrono::microseconds (0));
+
+      // Execute and commit the units that are still queued and stop the
+      // committer thread.
+      //
+      ~group_commit ();
+
+      std::future<void>
+      submit (work_type);
+
+      // The callback is called on the committer thread and must not throw.
+      //
+      void
+      submit (work_type, callback_type);
+
+      // Block until all the units submitted so far have been executed and
+      // committed (or have failed).
+      //
+      void
+      flush ();
+
+      struct statistics
+      {
+        std::size_t units;        // Number of units executed.
+        std::size_t failed;       // Number of units that have failed.
+        std::size_t transactions; // Number of transactions.
+        std::size_t max_batch;    // Maximum number of units in a single
+                                  // transaction.
+        std::size_t queued;       // Number of units currently queued.
+      };
+
+      statistics
+      stats ();
+
+    private:
+      group_commit (const group_commit&);
+      group_commit& operator= (const group_commit&);
+
+    private:
+      struct unit
+      {
+        work_type work;
+        callback_type callback; // If empty, then use the promise.
+        std::promise<void> promise;
+      };
+
+      void
+      run ();
+
+      void
+      execute (std::vector<unit>&);
+
+    private:
+      database_type& db_;
+      const std::size_t max_batch_;
+      const std::chrono::microseconds max_delay_;
+
+      // The following members are protected by the mutex.
+      //
+      std::mutex mutex_;
+      std::condition_variable cond_;      // Units queued or stop requested.
+      std::condition_variable done_cond_; // Units completed.
+
+      std::deque<unit> queue_;
+      bool stop_;
+      std::size_t submitted_;
+      std::size_t completed_;
+      statistics stats_;
+
+      std::thread thread_;
+    };
+  }
+}
+
+#endif // ODB_CXX11 && !ODB_THREADS_NONE
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_GROUP_COMMIT_HXX
@@ -42,8 +42,11 @@ namespace odb
           params_ (q.parameters ()),
           statement_ (s),
           statements_ (sts),
-          tc_ (svm)
+          tc_ (svm),
+          cache_ (false)
     {
+      if (std::size_t n = sts.connection ().database ().result_prefetch ())
+        statement_->prefetch (n);
     }
 
     template <typename T>
@@ -102,13 +105,36 @@ namespace odb
     void no_id_object_result_impl<T>::
     cache ()
     {
+      // The rows are only fetched if and when size() is called (see
+      // object_result_impl::cache()).
+      //
+      cache_ = true;
     }
 
     template <typename T>
     std::size_t no_id_object_result_impl<T>::
     size ()
     {
-      throw result_not_cached ();
+      if (statement_ == 0 || !(cache_ || statement_->cached ()))
+        throw result_not_cached ();
+
+      cache_rows ();
+      return statement_->row_count ();
+    }
+
+    template <typename T>
+    void no_id_object_result_impl<T>::
+    cache_rows ()
+    {
+      if (!statement_->cached ())
+      {
+        statement_->cache ();
+
+        // The parameters are no longer needed once all the rows have
+        // been fetched.
+        //
+        params_.reset ();
+      }
     }
   }
 }
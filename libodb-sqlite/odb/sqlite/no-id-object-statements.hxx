@@ -48,7 +48,7 @@ namespace odb
       // Object image.
       //
       image_type&
-      image () {return image_;}
+      image (std::size_t i = 0) {return image_[i];}
 
       // Insert binding.
       //
@@ -109,7 +109,8 @@ namespace odb
       no_id_object_statements& operator= (const no_id_object_statements&);
 
     private:
-      image_type image_;
+      image_type image_[object_traits::batch];
+      unsigned long long status_[object_traits::batch];
 
       // Select binding.
       //
@@ -18,9 +18,15 @@ namespace odb
     no_id_object_statements (connection_type& conn)
         : statements_base (conn),
           select_image_binding_ (select_image_bind_, select_column_count),
-          insert_image_binding_ (insert_image_bind_, insert_column_count)
+          insert_image_binding_ (insert_image_bind_,
+                                 insert_column_count,
+                                 object_traits::batch,
+                                 sizeof (image_type),
+                                 status_)
     {
-      image_.version = 0;
+      for (std::size_t i (0); i < object_traits::batch; ++i)
+        image_[i].version = 0;
+
       select_image_version_ = 0;
       insert_image_version_ = 0;
 
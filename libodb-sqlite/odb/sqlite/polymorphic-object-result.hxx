@@ -46,11 +46,16 @@ namespace odb
       virtual
       ~polymorphic_object_result_impl ();
 
+      // If the join argument is not NULL, then the statement also
+      // contains the columns of the dynamic parts of the derived classes
+      // listed in the table.
+      //
       polymorphic_object_result_impl (
         const query_base&,
         const details::shared_ptr<select_statement>&,
         statements_type&,
-        const schema_version_migration*);
+        const schema_version_migration*,
+        const polymorphic_join_column* join = 0);
 
       virtual void
       load (object_type*, bool fetch);
@@ -79,6 +84,9 @@ namespace odb
       void
       load_image ();
 
+      void
+      cache_rows ();
+
     private:
       // We need to hold on to the query parameters because SQLite uses
       // the parameter buffers to find each next row.
@@ -87,6 +95,8 @@ namespace odb
       details::shared_ptr<select_statement> statement_;
       statements_type& statements_;
       object_traits_calls<object_type> tc_;
+      const polymorphic_join_column* join_;
+      bool cache_;
     };
   }
 }
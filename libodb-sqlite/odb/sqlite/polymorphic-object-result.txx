@@ -40,13 +40,26 @@ namespace odb
       const query_base& q,
       const details::shared_ptr<select_statement>& s,
       statements_type& sts,
-      const schema_version_migration* svm)
+      const schema_version_migration* svm,
+      const polymorphic_join_column* join)
         : base_type (sts.connection ()),
           params_ (q.parameters ()),
           statement_ (s),
           statements_ (sts),
-          tc_ (svm)
+          tc_ (svm),
+          join_ (join),
+          cache_ (false)
     {
+      // The dynamic parts cannot be loaded from the prefetched rows so
+      // don't prefetch if they are part of the result.
+      //
+      statement_->wide (join != 0);
+
+      if (join == 0)
+      {
+        if (std::size_t n = sts.connection ().database ().result_prefetch ())
+          statement_->prefetch (n);
+      }
     }
 
     template <typename T>
@@ -148,7 +161,42 @@ namespace odb
       if (&pi != &object_traits::info)
       {
         std::size_t d (object_traits::depth);
-        pi.dispatch (info_type::call_load, this->db_, pobj, &d);
+
+        // If the dynamic part is in the current row, then redirect its
+        // SELECT statement there instead of executing it. This does not
+        // work for cached rows which only contain our own columns.
+        //
+        bool r (false);
+        if (join_ != 0 && !statement_->cached ())
+        {
+          for (const polymorphic_join_column* j (join_); j->type != 0; ++j)
+          {
+            if (*j->type == pi.type)
+            {
+              rsts.redirect (statement_.get (), j->column, j->type, d);
+              r = true;
+              break;
+            }
+          }
+        }
+
+        try
+        {
+          pi.dispatch (info_type::call_load, this->db_, pobj, &d);
+        }
+        catch (...)
+        {
+          if (r)
+            rsts.redirect (0);
+
+          throw;
+        }
+
+        // Normally the redirect is consumed by the dispatched load but
+        // it may also end up not executing the statement.
+        //
+        if (r)
+          rsts.redirect (0);
       };
 
       rsts.load_delayed (tc_.version ());
@@ -275,13 +323,36 @@ namespace odb
     void polymorphic_object_result_impl<T>::
     cache ()
     {
+      // The rows are only fetched if and when size() is called (see
+      // object_result_impl::cache()).
+      //
+      cache_ = true;
     }
 
     template <typename T>
     std::size_t polymorphic_object_result_impl<T>::
     size ()
     {
-      throw result_not_cached ();
+      if (statement_ == 0 || !(cache_ || statement_->cached ()))
+        throw result_not_cached ();
+
+      cache_rows ();
+      return statement_->row_count ();
+    }
+
+    template <typename T>
+    void polymorphic_object_result_impl<T>::
+    cache_rows ()
+    {
+      if (!statement_->cached ())
+      {
+        statement_->cache ();
+
+        // The parameters are no longer needed once all the rows have
+        // been fetched.
+        //
+        params_.reset ();
+      }
     }
   }
 }
@@ -6,7 +6,8 @@
 
 #include <odb/pre.hxx>
 
-#include <cstddef> // std::size_t
+#include <cstddef>  // std::size_t
+#include <typeinfo> // std::type_info
 
 #include <odb/forward.hxx>
 #include <odb/traits.hxx>
@@ -25,6 +26,17 @@ namespace odb
 {
   namespace sqlite
   {
+    // Entry in the table of derived class columns that are part of the
+    // polymorphic object query statement (see --generate-polymorphic-join
+    // in the ODB compiler). The table is terminated with an entry that
+    // has NULL type.
+    //
+    struct polymorphic_join_column
+    {
+      const std::type_info* type; // Concrete derived class.
+      std::size_t column;         // First column of its dynamic part.
+    };
+
     //
     // Implementation for polymorphic objects.
     //
@@ -113,6 +125,44 @@ namespace odb
         return *find_discriminator_;
       }
 
+      // Redirect the next load of the dynamic part of an object of the
+      // specified type (static type depth) to the columns of the current
+      // query result row starting with the specified one. Pass NULL
+      // statement to cancel.
+      //
+      void
+      redirect (select_statement_type* s,
+                std::size_t column = 0,
+                const std::type_info* type = 0,
+                std::size_t depth = 0)
+      {
+        redirect_ = s;
+        redirect_column_ = column;
+        redirect_type_ = type;
+        redirect_depth_ = depth;
+      }
+
+      // Return the statement and column if the load of the specified
+      // type and depth is redirected and NULL otherwise. The redirect
+      // only applies to a single load.
+      //
+      select_statement_type*
+      redirected (const std::type_info& type,
+                  std::size_t depth,
+                  std::size_t& column)
+      {
+        select_statement_type* r (redirect_);
+
+        if (r != 0 && depth == redirect_depth_ && type == *redirect_type_)
+        {
+          column = redirect_column_;
+          redirect_ = 0;
+          return r;
+        }
+
+        return 0;
+      }
+
     public:
       polymorphic_root_object_statements (connection_type&);
 
@@ -160,6 +210,11 @@ namespace odb
       bind discriminator_id_image_bind_[id_column_count];
 
       details::shared_ptr<select_statement_type> find_discriminator_;
+
+      select_statement_type* redirect_;
+      std::size_t redirect_column_;
+      const std::type_info* redirect_type_;
+      std::size_t redirect_depth_;
     };
 
     template <typename T>
@@ -339,6 +394,14 @@ namespace odb
               select_image_bindings_[i]));
         }
 
+        // Load the dynamic part from the query result if so requested
+        // (see polymorphic_object_result_impl::load()).
+        //
+        std::size_t c;
+        if (select_statement_type* s =
+              root_statements_.redirected (typeid (object_type), i, c))
+          p->redirect (*s, c);
+
         return *p;
       }
 
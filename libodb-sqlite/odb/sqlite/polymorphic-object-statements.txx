@@ -41,6 +41,8 @@ namespace odb
       discriminator_image_version_ = 0;
       discriminator_id_image_version_ = 0;
 
+      redirect_ = 0;
+
       std::memset (discriminator_image_bind_,
                    0,
                    sizeof (discriminator_image_bind_));
@@ -1,6 +1,7 @@
 // file      : odb/sqlite/query-dynamic.cxx
 // license   : GNU GPL v2; see accompanying LICENSE file
 
+#include <vector>
 #include <cstddef> // std::size_t
 
 #include <odb/sqlite/query-dynamic.hxx>
@@ -11,11 +12,32 @@ namespace odb
 {
   namespace sqlite
   {
+    // Cached translation of a dynamic query. The parameters are recorded
+    // in the order they appear in the clause and are recreated from the
+    // dynamic query values every time the translation is reused. This way
+    // the same query can still be executed concurrently.
+    //
+    struct query_translation: odb::query_translation
+    {
+      struct param
+      {
+        query_param_factory factory;
+        const void* value;
+        bool by_ref;
+      };
+
+      query_base::clause_type clause;
+      std::vector<param> params;
+    };
+
     static const char* logic_operators[] = {") AND (", ") OR ("};
     static const char* comp_operators[] = {"=", "!=", "<", ">", "<=", ">="};
 
     static void
-    translate (query_base& q, const odb::query_base& s, size_t p)
+    translate (query_base& q,
+               const odb::query_base& s,
+               size_t p,
+               query_translation& t)
     {
       typedef odb::query_base::clause_part part;
 
@@ -46,8 +68,13 @@ namespace odb
           const odb::query_param* p (
             reinterpret_cast<const odb::query_param*> (x.data));
 
-          q.append (f (p->value, x.kind == part::kind_param_ref),
-                    c->conversion ());
+          query_translation::param tp;
+          tp.factory = f;
+          tp.value = p->value;
+          tp.by_ref = x.kind == part::kind_param_ref;
+          t.params.push_back (tp);
+
+          q.append (f (tp.value, tp.by_ref), c->conversion ());
           break;
         }
       case part::kind_native:
@@ -63,31 +90,31 @@ namespace odb
         }
       case part::op_add:
         {
-          translate (q, s, x.data);
-          translate (q, s, p - 1);
+          translate (q, s, x.data, t);
+          translate (q, s, p - 1, t);
           break;
         }
       case part::op_and:
       case part::op_or:
         {
           q += "(";
-          translate (q, s, x.data);
+          translate (q, s, x.data, t);
           q += logic_operators[x.kind - part::op_and];
-          translate (q, s, p - 1);
+          translate (q, s, p - 1, t);
           q += ")";
           break;
         }
       case part::op_not:
         {
           q += "NOT (";
-          translate (q, s, p - 1);
+          translate (q, s, p - 1, t);
           q += ")";
           break;
         }
       case part::op_null:
       case part::op_not_null:
         {
-          translate (q, s, p - 1);
+          translate (q, s, p - 1, t);
           q += (x.kind == part::op_null ? "IS NULL" : "IS NOT NULL");
           break;
         }
@@ -97,7 +124,7 @@ namespace odb
           {
             size_t b (p - x.data);
 
-            translate (q, s, b - 1); // column
+            translate (q, s, b - 1, t); // column
             q += "IN (";
 
             for (size_t i (b); i != p; ++i)
@@ -105,7 +132,7 @@ namespace odb
               if (i != b)
                 q += ",";
 
-              translate (q, s, i);
+              translate (q, s, i, t);
             }
 
             q += ")";
@@ -117,18 +144,18 @@ namespace odb
         }
       case part::op_like:
         {
-          translate (q, s, p - 2); // column
+          translate (q, s, p - 2, t); // column
           q += "LIKE";
-          translate (q, s, p - 1); // pattern
+          translate (q, s, p - 1, t); // pattern
           break;
         }
       case part::op_like_escape:
         {
-          translate (q, s, p - 3); // column
+          translate (q, s, p - 3, t); // column
           q += "LIKE";
-          translate (q, s, p - 2); // pattern
+          translate (q, s, p - 2, t); // pattern
           q += "ESCAPE";
-          translate (q, s, p - 1); // escape
+          translate (q, s, p - 1, t); // escape
           break;
         }
       case part::op_eq:
@@ -138,9 +165,9 @@ namespace odb
       case part::op_le:
       case part::op_ge:
         {
-          translate (q, s, x.data);
+          translate (q, s, x.data, t);
           q += comp_operators[x.kind - part::op_eq];
-          translate (q, s, p - 1);
+          translate (q, s, p - 1, t);
           break;
         }
       }
@@ -150,8 +177,36 @@ namespace odb
     query_base (const odb::query_base& q)
         : parameters_ (new (details::shared) query_params)
     {
-      if (!q.empty ())
-        translate (*this, q, q.clause ().size () - 1);
+      if (q.empty ())
+        return;
+
+      // If this query has already been translated, then reuse the clause
+      // and only create the parameters.
+      //
+      details::shared_ptr<odb::query_translation> c (
+        q.translation (id_sqlite));
+
+      if (c)
+      {
+        const query_translation& t (
+          static_cast<const query_translation&> (*c));
+
+        clause_ = t.clause;
+
+        for (vector<query_translation::param>::const_iterator i (
+               t.params.begin ()); i != t.params.end (); ++i)
+          parameters_->add (i->factory (i->value, i->by_ref));
+
+        return;
+      }
+
+      details::shared_ptr<query_translation> t (
+        new (details::shared) query_translation);
+
+      translate (*this, q, q.clause ().size () - 1, *t);
+
+      t->clause = clause_;
+      q.translation (id_sqlite, t);
     }
   }
 }
@@ -114,6 +114,18 @@ namespace odb
         binding_.version++;
     }
 
+    bool query_params::
+    reference () const
+    {
+      for (size_t i (0); i < params_.size (); ++i)
+      {
+        if (params_[i]->reference ())
+          return true;
+      }
+
+      return false;
+    }
+
     // query_base
     //
 
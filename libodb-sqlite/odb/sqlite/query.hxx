@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <cstddef> // std::size_t
+#include <cstring> // std::memset
 
 #include <odb/forward.hxx>            // odb::query_column
 #include <odb/query.hxx>
@@ -134,6 +135,11 @@ namespace odb
       void
       init ();
 
+      // Return true if any of the parameters is by-reference.
+      //
+      bool
+      reference () const;
+
       binding_type&
       binding () {return binding_;}
 
@@ -455,6 +461,8 @@ namespace odb
       append (const char* table, const char* column);
 
     private:
+      friend struct query_translation; // In query-dynamic.cxx.
+
       typedef std::vector<clause_part> clause_type;
 
       clause_type clause_;
@@ -1510,7 +1518,7 @@ namespace odb
       bind (sqlite::bind* b)
       {
         b->type = image_traits<T, id_text>::bind_value;
-        b->buffer = buffer_.data ();
+        b->buffer = buffer_.data_ptr ();
         b->size = &size_;
       }
 
@@ -1547,7 +1555,7 @@ namespace odb
       bind (sqlite::bind* b)
       {
         b->type = sqlite::bind::blob;
-        b->buffer = buffer_.data ();
+        b->buffer = buffer_.data_ptr ();
         b->size = &size_;
       }
 
@@ -1583,6 +1591,59 @@ namespace odb
       query_param_impl (ref_bind<T> r) : query_param_impl<T, id_blob> (r) {}
       query_param_impl (val_bind<T> v) : query_param_impl<T, id_blob> (v) {}
     };
+
+    // Object id parameter. Used to select several objects by id with a
+    // single statement (see database::load()).
+    //
+    template <typename T>
+    struct object_id_param: query_param
+    {
+      typedef access::object_traits_impl<T, id_sqlite> object_traits;
+
+      explicit
+      object_id_param (const typename object_traits::id_type& id)
+          : query_param (0), image_ ()
+      {
+        object_traits::init (image_, id);
+      }
+
+      virtual bool
+      init ()
+      {
+        return false;
+      }
+
+      virtual void
+      bind (sqlite::bind* b)
+      {
+        // The id image binding of an optimistic object also includes
+        // the version.
+        //
+        sqlite::bind t[object_traits::id_column_count +
+                       object_traits::managed_optimistic_column_count];
+        std::memset (t, 0, sizeof (t));
+        object_traits::bind (t, image_);
+        *b = t[0];
+      }
+
+    private:
+      typename object_traits::id_image_type image_;
+    };
+
+    // Return the table.column IN (?, ...) condition for the specified
+    // object ids (the object must have a simple id). To limit the number
+    // of distinct statements that end up in the statement cache, the
+    // number of parameters is rounded up to a power of two with the last
+    // id repeated.
+    //
+    template <typename T>
+    query_base
+    object_id_in (
+      const char* table,
+      const char* column,
+      const char* conv,
+      const typename access::object_traits_impl<T, id_sqlite>::id_type** ids,
+      std::size_t n);
   }
 }
 
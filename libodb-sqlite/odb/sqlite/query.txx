@@ -164,5 +164,41 @@ namespace odb
       q.append<T, ID> (val_bind<T> (e), conversion_);
       return q;
     }
+
+    //
+    // object_id_in
+    //
+
+    template <typename T>
+    query_base
+    object_id_in (
+      const char* table,
+      const char* column,
+      const char* conv,
+      const typename access::object_traits_impl<T, id_sqlite>::id_type** ids,
+      std::size_t n)
+    {
+      std::size_t m (1);
+      while (m < n)
+        m *= 2;
+
+      query_base q (table, column);
+      q += "IN (";
+
+      for (std::size_t i (0); i != m; ++i)
+      {
+        if (i != 0)
+          q += ",";
+
+        q.append (
+          details::shared_ptr<query_param> (
+            new (details::shared) object_id_param<T> (
+              *ids[i < n ? i : n - 1])),
+          conv);
+      }
+
+      q += ")";
+      return q;
+    }
   }
 }
@@ -0,0 +1,166 @@
+// file      : odb/sqlite/sharded-database.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/sharded-database.hxx>
+
+#if defined(ODB_CXX11) && !defined(ODB_THREADS_NONE)
+
+#include <thread>
+#include <cassert>
+#include <utility>   // std::move
+#include <exception> // std::exception_ptr
+
+using namespace std;
+
+namespace odb
+{
+  namespace sqlite
+  {
+    sharded_database::
+    sharded_database (vector<database_ptr> shards)
+        : shards_ (move (shards))
+    {
+      assert (!shards_.empty ());
+    }
+
+    sharded_database::
+    sharded_database (const vector<string>& names,
+                      int flags,
+                      bool foreign_keys,
+                      const string& vfs)
+    {
+      assert (!names.empty ());
+
+      shards_.reserve (names.size ());
+
+      for (size_t i (0); i != names.size (); ++i)
+        shards_.push_back (
+          database_ptr (
+            new database_type (names[i], flags, foreign_keys, vfs)));
+    }
+
+    void sharded_database::
+    execute (const function<void (size_t)>& f, bool parallel)
+    {
+      size_t n (shards_.size ());
+      vector<exception_ptr> es (n);
+
+      // Note that the calls are never made on the calling thread since
+      // it may have a current transaction.
+      //
+      if (parallel)
+      {
+        vector<thread> ts;
+        ts.reserve (n);
+
+        for (size_t i (0); i != n; ++i)
+        {
+          ts.push_back (
+            thread (
+              [&f, &es, i] ()
+              {
+                try
+                {
+                  f (i);
+                }
+                catch (...)
+                {
+                  es[i] = current_exception ();
+                }
+              }));
+        }
+
+        for (size_t i (0); i != n; ++i)
+          ts[i].join ();
+      }
+      else
+      {
+        thread t (
+          [&f, &es, n] ()
+          {
+            for (size_t i (0); i != n; ++i)
+            {
+              try
+              {
+                f (i);
+              }
+              catch (...)
+              {
+                es[i] = current_exception ();
+              }
+            }
+          });
+
+        t.join ();
+      }
+
+      for (size_t i (0); i != n; ++i)
+      {
+        if (es[i])
+          rethrow_exception (es[i]);
+      }
+    }
+
+    //
+    // shard_transaction
+    //
+
+    sharded_database::shard_transaction::
+    shard_transaction (database_type& db, bool write)
+        : suspended_ (0)
+    {
+      if (odb::transaction::has_current ())
+      {
+        odb::transaction& c (odb::transaction::current ());
+
+        if (&c.database () == &db)
+          return; // Use the current transaction.
+
+        suspended_ = &c;
+        odb::transaction::reset_current ();
+      }
+
+      try
+      {
+        t_.reset (write ? db.begin_immediate () : db.begin ());
+      }
+      catch (...)
+      {
+        if (suspended_ != 0)
+          odb::transaction::current (*suspended_);
+
+        throw;
+      }
+    }
+
+    sharded_database::shard_transaction::
+    ~shard_transaction ()
+    {
+      // Roll back our transaction if it is still active (that is, an
+      // exception was thrown) and restore the suspended one.
+      //
+      if (!t_.finalized ())
+      {
+        try
+        {
+          t_.rollback ();
+        }
+        catch (...)
+        {
+        }
+      }
+
+      if (suspended_ != 0)
+        odb::transaction::current (*suspended_);
+    }
+
+    void sharded_database::shard_transaction::
+    commit ()
+    {
+      if (!t_.finalized ())
+        t_.commit ();
+    }
+  }
+}
+
+#endif // ODB_CXX11 && !ODB_THREADS_NONE
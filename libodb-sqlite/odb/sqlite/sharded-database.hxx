@@ -0,0 +1,243 @@
+// file      : odb/sqlite/sharded-database.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_SHARDED_DATABASE_HXX
+#define ODB_SQLITE_SHARDED_DATABASE_HXX
+
+#include <odb/pre.hxx>
+
+#include <odb/details/config.hxx> // ODB_CXX11, ODB_THREADS_NONE
+
+#if defined(ODB_CXX11) && !defined(ODB_THREADS_NONE)
+
+#include <map>
+#include <memory>   // std::unique_ptr
+#include <string>
+#include <vector>
+#include <cstddef>  // std::size_t
+#include <typeinfo>
+#include <functional>
+
+#include <odb/traits.hxx>
+#include <odb/result.hxx>
+#include <odb/details/type-info.hxx>
+
+#include <odb/sqlite/version.hxx>
+#include <odb/sqlite/forward.hxx>
+#include <odb/sqlite/query.hxx>
+#include <odb/sqlite/database.hxx>
+#include <odb/sqlite/transaction.hxx>
+#include <odb/sqlite/exceptions.hxx>
+#include <odb/sqlite/details/export.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // One logical database that is horizontally partitioned over several
+    // SQLite databases (shards), normally separate files, each with its
+    // own connection factory. Since every shard has its own writer, the
+    // write throughput scales with the number of shards.
+    //
+    // Each object lives in exactly one shard which is determined by the
+    // shard key function specified for its type with shard_key(). The
+    // function is passed the object id and should return a value that is
+    // then taken modulo the number of shards. As a result, object ids
+    // cannot be assigned automatically by the database. Note also that
+    // the shard key functions should be specified before the sharded
+    // database is used from multiple threads.
+    //
+    // The single object operations (persist(), load(), etc) are performed
+    // in the current transaction if it is on the object's shard and
+    // otherwise in a separate transaction on this shard which is committed
+    // before the function returns (any current transaction on another
+    // database is suspended for the duration of the call).
+    //
+    // The bulk operations and queries are performed on all the shards in
+    // parallel, each in its own transaction and on its own thread (so the
+    // current transaction and session, if any, are not used). There is no
+    // atomicity across shards: if an operation fails on one shard, it may
+    // have already been committed on others. In this case the exception
+    // from the first failed shard is rethrown.
+    //
+    class LIBODB_SQLITE_EXPORT sharded_database
+    {
+    public:
+      typedef sqlite::database database_type;
+      typedef std::unique_ptr<database_type> database_ptr;
+
+      explicit
+      sharded_database (std::vector<database_ptr>);
+
+      // Open each of the specified database files as a shard using the
+      // default connection factory.
+      //
+      explicit
+      sharded_database (const std::vector<std::string>& names,
+                        int flags = SQLITE_OPEN_READWRITE,
+                        bool foreign_keys = true,
+                        const std::string& vfs = "");
+
+      std::size_t
+      shards () const {return shards_.size ();}
+
+      database_type&
+      shard (std::size_t i) {return *shards_[i];}
+
+      // Shard key.
+      //
+    public:
+      template <typename T>
+      void
+      shard_key (std::function<
+                   std::size_t (const typename object_traits<T>::id_type&)>);
+
+      // Return the index of the shard for the object id. Throw no_shard_key
+      // if no shard key function was specified for this object type.
+      //
+      template <typename T>
+      std::size_t
+      shard_index (const typename object_traits<T>::id_type&) const;
+
+      template <typename T>
+      database_type&
+      shard_of (const typename object_traits<T>::id_type& id)
+      {
+        return *shards_[shard_index<T> (id)];
+      }
+
+      // Object persistence API.
+      //
+    public:
+      template <typename T>
+      typename object_traits<T>::id_type
+      persist (T& object);
+
+      template <typename T>
+      typename object_traits<T>::pointer_type
+      load (const typename object_traits<T>::id_type&);
+
+      template <typename T>
+      void
+      load (const typename object_traits<T>::id_type&, T& object);
+
+      template <typename T>
+      typename object_traits<T>::pointer_type
+      find (const typename object_traits<T>::id_type&);
+
+      template <typename T>
+      bool
+      find (const typename object_traits<T>::id_type&, T& object);
+
+      template <typename T>
+      void
+      update (T& object);
+
+      template <typename T>
+      void
+      erase (const typename object_traits<T>::id_type&);
+
+      template <typename T>
+      void
+      erase (T& object);
+
+      // Bulk persist and update. The range can contain references or
+      // pointers (including smart pointers) to objects. The objects are
+      // partitioned by shard and each partition is persisted or updated
+      // in a single transaction.
+      //
+      template <typename I>
+      void
+      persist (I begin, I end);
+
+      template <typename I>
+      void
+      update (I begin, I end);
+
+      // Query API. The query is executed on all the shards and the results
+      // are returned in the shard order. The second version merges the
+      // results using the specified comparison function object (called
+      // with two objects or views) assuming that the result from each
+      // shard is ordered according to this function (for example, with
+      // ORDER BY in the query). Queries with by-reference parameters are
+      // executed on the shards sequentially since their parameter images
+      // are shared.
+      //
+    public:
+      template <typename T>
+      std::vector<typename odb::result<T>::pointer_type>
+      query (const sqlite::query_base& = sqlite::query_base (true));
+
+      template <typename T, typename C>
+      std::vector<typename odb::result<T>::pointer_type>
+      query (const sqlite::query_base&, C compare);
+
+      // Erase the objects matching the query on all the shards. Return the
+      // total number of objects erased.
+      //
+      template <typename T>
+      unsigned long long
+      erase_query (const sqlite::query_base& = sqlite::query_base (true));
+
+    private:
+      sharded_database (const sharded_database&);
+      sharded_database& operator= (const sharded_database&);
+
+    private:
+      // Execute the query on all the shards and return the concatenated
+      // results, with the number of objects from each shard in sizes.
+      //
+      template <typename T>
+      std::vector<typename odb::result<T>::pointer_type>
+      query_ (const sqlite::query_base&, std::vector<std::size_t>& sizes);
+
+      // Call the function for each shard index, on a separate thread for
+      // each shard or, if parallel is false, for all of them on a single
+      // thread. Wait for all the calls to complete and rethrow the first
+      // exception, if any.
+      //
+      void
+      execute (const std::function<void (std::size_t)>&, bool parallel = true);
+
+      // Make a transaction on the shard current for the duration of a
+      // single object operation unless one already is.
+      //
+      class LIBODB_SQLITE_EXPORT shard_transaction
+      {
+      public:
+        shard_transaction (database_type&, bool write);
+        ~shard_transaction ();
+
+        void
+        commit ();
+
+      private:
+        shard_transaction (const shard_transaction&);
+        shard_transaction& operator= (const shard_transaction&);
+
+      private:
+        transaction t_; // Finalized if we use the current transaction.
+        odb::transaction* suspended_;
+      };
+
+    private:
+      typedef std::function<std::size_t (const void*)> key_function;
+
+      typedef
+      std::map<const std::type_info*,
+               key_function,
+               odb::details::type_info_comparator> key_map;
+
+      std::vector<database_ptr> shards_;
+      key_map keys_;
+    };
+  }
+}
+
+#include <odb/sqlite/sharded-database.txx>
+
+#endif // ODB_CXX11 && !ODB_THREADS_NONE
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_SHARDED_DATABASE_HXX
@@ -0,0 +1,368 @@
+// file      : odb/sqlite/sharded-database.txx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <iterator>  // std::iterator_traits
+#include <algorithm> // std::inplace_merge
+#include <utility>   // std::move
+
+namespace odb
+{
+  namespace sqlite
+  {
+    template <typename T>
+    void sharded_database::
+    shard_key (std::function<
+                 std::size_t (const typename object_traits<T>::id_type&)> f)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef typename object_traits<T>::id_type id_type;
+
+      keys_[&typeid (object_type)] = [f] (const void* id) -> std::size_t
+      {
+        return f (*static_cast<const id_type*> (id));
+      };
+    }
+
+    template <typename T>
+    std::size_t sharded_database::
+    shard_index (const typename object_traits<T>::id_type& id) const
+    {
+      typedef typename object_traits<T>::object_type object_type;
+
+      key_map::const_iterator i (keys_.find (&typeid (object_type)));
+
+      if (i == keys_.end ())
+        throw no_shard_key ();
+
+      return i->second (&id) % shards_.size ();
+    }
+
+    template <typename T>
+    typename object_traits<T>::id_type sharded_database::
+    persist (T& obj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+      typedef odb::object_traits<object_type> object_traits;
+
+      // Compiler error pointing here? Objects in a sharded database must
+      // have application-assigned ids since the id determines the shard.
+      //
+      static_assert (!object_traits::auto_id,
+                     "sharded object id cannot be assigned automatically");
+
+      database_type& db (shard_of<object_type> (object_traits::id (obj)));
+
+      shard_transaction t (db, true);
+      typename object_traits::id_type r (db.persist (obj));
+      t.commit ();
+      return r;
+    }
+
+    template <typename T>
+    typename object_traits<T>::pointer_type sharded_database::
+    load (const typename object_traits<T>::id_type& id)
+    {
+      database_type& db (shard_of<T> (id));
+
+      shard_transaction t (db, false);
+      typename object_traits<T>::pointer_type r (db.load<T> (id));
+      t.commit ();
+      return r;
+    }
+
+    template <typename T>
+    void sharded_database::
+    load (const typename object_traits<T>::id_type& id, T& obj)
+    {
+      database_type& db (shard_of<T> (id));
+
+      shard_transaction t (db, false);
+      db.load (id, obj);
+      t.commit ();
+    }
+
+    template <typename T>
+    typename object_traits<T>::pointer_type sharded_database::
+    find (const typename object_traits<T>::id_type& id)
+    {
+      database_type& db (shard_of<T> (id));
+
+      shard_transaction t (db, false);
+      typename object_traits<T>::pointer_type r (db.find<T> (id));
+      t.commit ();
+      return r;
+    }
+
+    template <typename T>
+    bool sharded_database::
+    find (const typename object_traits<T>::id_type& id, T& obj)
+    {
+      database_type& db (shard_of<T> (id));
+
+      shard_transaction t (db, false);
+      bool r (db.find (id, obj));
+      t.commit ();
+      return r;
+    }
+
+    template <typename T>
+    void sharded_database::
+    update (T& obj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+
+      database_type& db (
+        shard_of<object_type> (object_traits<object_type>::id (obj)));
+
+      shard_transaction t (db, true);
+      db.update (obj);
+      t.commit ();
+    }
+
+    template <typename T>
+    void sharded_database::
+    erase (const typename object_traits<T>::id_type& id)
+    {
+      database_type& db (shard_of<T> (id));
+
+      shard_transaction t (db, true);
+      db.erase<T> (id);
+      t.commit ();
+    }
+
+    template <typename T>
+    void sharded_database::
+    erase (T& obj)
+    {
+      typedef typename object_traits<T>::object_type object_type;
+
+      database_type& db (
+        shard_of<object_type> (object_traits<object_type>::id (obj)));
+
+      shard_transaction t (db, true);
+      db.erase (obj);
+      t.commit ();
+    }
+
+    template <typename I>
+    void sharded_database::
+    persist (I b, I e)
+    {
+      typedef typename std::iterator_traits<I>::value_type value_type;
+
+      // object_pointer_traits<T>::object_type can be const.
+      //
+      typedef object_pointer_traits<value_type> opt;
+      typedef typename opt::object_type T;
+
+      typedef typename object_traits<T>::object_type object_type;
+      typedef odb::object_traits<object_type> object_traits;
+
+      // Compiler error pointing here? Objects in a sharded database must
+      // have application-assigned ids since the id determines the shard.
+      //
+      static_assert (!object_traits::auto_id,
+                     "sharded object id cannot be assigned automatically");
+
+      std::vector<std::vector<const T*> > parts (shards_.size ());
+
+      for (; b != e; ++b)
+      {
+        const T& obj (opt::get_ref (*b));
+        parts[shard_index<object_type> (object_traits::id (obj))].push_back (
+          &obj);
+      }
+
+      execute (
+        [this, &parts] (std::size_t i)
+        {
+          std::vector<const T*>& p (parts[i]);
+
+          if (p.empty ())
+            return;
+
+          database_type& db (*shards_[i]);
+
+          db.transact (
+            [&db, &p] ()
+            {
+              for (std::size_t j (0); j != p.size (); ++j)
+                db.persist (*p[j]);
+            },
+            transaction_impl::immediate);
+        });
+    }
+
+    template <typename I>
+    void sharded_database::
+    update (I b, I e)
+    {
+      typedef typename std::iterator_traits<I>::value_type value_type;
+
+      // object_pointer_traits<T>::object_type can be const.
+      //
+      typedef object_pointer_traits<value_type> opt;
+      typedef typename opt::object_type T;
+
+      typedef typename object_traits<T>::object_type object_type;
+      typedef odb::object_traits<object_type> object_traits;
+
+      std::vector<std::vector<const T*> > parts (shards_.size ());
+
+      for (; b != e; ++b)
+      {
+        const T& obj (opt::get_ref (*b));
+        parts[shard_index<object_type> (object_traits::id (obj))].push_back (
+          &obj);
+      }
+
+      execute (
+        [this, &parts] (std::size_t i)
+        {
+          std::vector<const T*>& p (parts[i]);
+
+          if (p.empty ())
+            return;
+
+          database_type& db (*shards_[i]);
+
+          db.transact (
+            [&db, &p] ()
+            {
+              for (std::size_t j (0); j != p.size (); ++j)
+                db.update (*p[j]);
+            },
+            transaction_impl::immediate);
+        });
+    }
+
+    template <typename T>
+    std::vector<typename odb::result<T>::pointer_type> sharded_database::
+    query (const sqlite::query_base& q)
+    {
+      std::vector<std::size_t> sizes;
+      return query_<T> (q, sizes);
+    }
+
+    template <typename T, typename C>
+    std::vector<typename odb::result<T>::pointer_type> sharded_database::
+    query (const sqlite::query_base& q, C compare)
+    {
+      typedef typename odb::result<T>::pointer_type pointer_type;
+
+      std::vector<std::size_t> sizes;
+      std::vector<pointer_type> r (query_<T> (q, sizes));
+
+      // Merge the sorted runs from each shard pairwise, doubling the
+      // length of the runs on each pass.
+      //
+      auto cmp ([&compare] (const pointer_type& x, const pointer_type& y)
+                {
+                  return compare (*x, *y);
+                });
+
+      std::vector<std::size_t> bounds (1, 0);
+      for (std::size_t i (0); i != sizes.size (); ++i)
+        bounds.push_back (bounds.back () + sizes[i]);
+
+      while (bounds.size () > 2)
+      {
+        std::vector<std::size_t> merged (1, 0);
+
+        for (std::size_t i (2); i < bounds.size (); i += 2)
+        {
+          std::inplace_merge (r.begin () + bounds[i - 2],
+                              r.begin () + bounds[i - 1],
+                              r.begin () + bounds[i],
+                              cmp);
+          merged.push_back (bounds[i]);
+        }
+
+        if (bounds.size () % 2 == 0) // Odd number of runs.
+          merged.push_back (bounds.back ());
+
+        bounds.swap (merged);
+      }
+
+      return r;
+    }
+
+    template <typename T>
+    std::vector<typename odb::result<T>::pointer_type> sharded_database::
+    query_ (const sqlite::query_base& q, std::vector<std::size_t>& sizes)
+    {
+      typedef typename odb::result<T>::pointer_type pointer_type;
+      typedef std::vector<pointer_type> pointers;
+
+      std::vector<pointers> parts (shards_.size ());
+
+      execute (
+        [this, &parts, &q] (std::size_t i)
+        {
+          pointers& p (parts[i]);
+          database_type& db (*shards_[i]);
+
+          db.transact (
+            [&db, &p, &q] ()
+            {
+              p.clear (); // In case of a retry.
+
+              odb::result<T> r (db.query<T> (q));
+
+              for (typename odb::result<T>::iterator j (r.begin ());
+                   j != r.end ();
+                   ++j)
+                p.push_back (j.load ());
+            });
+        },
+        !q.parameters ()->reference ());
+
+      pointers r;
+      sizes.resize (parts.size ());
+
+      std::size_t n (0);
+      for (std::size_t i (0); i != parts.size (); ++i)
+        n += (sizes[i] = parts[i].size ());
+
+      r.reserve (n);
+
+      for (std::size_t i (0); i != parts.size (); ++i)
+      {
+        pointers& p (parts[i]);
+
+        for (std::size_t j (0); j != p.size (); ++j)
+          r.push_back (std::move (p[j]));
+      }
+
+      return r;
+    }
+
+    template <typename T>
+    unsigned long long sharded_database::
+    erase_query (const sqlite::query_base& q)
+    {
+      std::vector<unsigned long long> counts (shards_.size (), 0);
+
+      execute (
+        [this, &counts, &q] (std::size_t i)
+        {
+          database_type& db (*shards_[i]);
+          unsigned long long& c (counts[i]);
+
+          db.transact (
+            [&db, &c, &q] ()
+            {
+              c = db.erase_query<T> (q);
+            },
+            transaction_impl::immediate);
+        },
+        !q.parameters ()->reference ());
+
+      unsigned long long r (0);
+      for (std::size_t i (0); i != counts.size (); ++i)
+        r += counts[i];
+
+      return r;
+    }
+  }
+}
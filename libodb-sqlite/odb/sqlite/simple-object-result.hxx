@@ -69,6 +69,12 @@ namespace odb
       void
       load_image ();
 
+      void
+      cache_rows ();
+
+      void
+      prefetch (bool fetch);
+
     private:
       // We need to hold on to the query parameters because SQLite uses
       // the parameter buffers to find each next row.
@@ -77,6 +83,17 @@ namespace odb
       details::shared_ptr<select_statement> statement_;
       statements_type& statements_;
       object_traits_calls<object_type> tc_;
+
+      // True if cache() was called. The rows are then fetched into memory
+      // on the first call to size().
+      //
+      bool cache_;
+
+      // Batch loading. The range of cached rows, [begin, end), whose ids
+      // are in the id images.
+      //
+      std::size_t batch_begin_;
+      std::size_t batch_end_;
     };
   }
 }
@@ -44,15 +44,28 @@ namespace odb
           params_ (q.parameters ()),
           statement_ (s),
           statements_ (sts),
-          tc_ (svm)
+          tc_ (svm),
+          cache_ (false),
+          batch_begin_ (0),
+          batch_end_ (0)
     {
+      // With batch loading the result is cached on the first load() so
+      // there is no point in prefetching.
+      //
+      if (!object_traits::batch_load)
+      {
+        if (std::size_t n = sts.connection ().database ().result_prefetch ())
+          statement_->prefetch (n);
+      }
     }
 
     template <typename T>
     void object_result_impl<T>::
     load (object_type& obj, bool fetch)
     {
-      if (fetch)
+      if (object_traits::batch_load)
+        prefetch (fetch);
+      else if (fetch)
         load_image ();
 
       // This is a top-level call so the statements cannot be locked.
@@ -79,8 +92,21 @@ namespace odb
         idb.version++;
       }
 
-      tc_.load_ (statements_, obj, false);
+      if (object_traits::batch_load)
+      {
+        idb.prefetch = &statements_.batch_load ().binding_;
+        tc_.load_ (statements_, obj, false);
+        idb.prefetch = 0;
+      }
+      else
+        tc_.load_ (statements_, obj, false);
+
       statements_.load_delayed (tc_.version ());
+
+      if (object_traits::dirty_tracking)
+        statements_.dirty_snapshot (
+          object_traits::id (obj), obj, tc_.version (), false);
+
       l.unlock ();
       object_traits::callback (this->db_, obj, callback_event::post_load);
     }
@@ -142,17 +168,91 @@ namespace odb
       }
     }
 
+    template <typename T>
+    void object_result_impl<T>::
+    prefetch (bool fetch)
+    {
+      // Load the ids of this and the following objects (up to the batch
+      // load size) into the batch load id images so that their containers
+      // can be loaded with a single statement execution. For this we need to
+      // be able to look ahead so the rows are fetched into memory.
+      //
+      cache_rows ();
+
+      select_statement& st (*statement_);
+      std::size_t p (st.position ());
+
+      if (p >= batch_begin_ && p < batch_end_)
+      {
+        if (fetch)
+          load_image ();
+
+        return;
+      }
+
+      std::size_t n (st.cache_size () - p + 1);
+      if (n > object_traits::batch_load)
+        n = object_traits::batch_load;
+
+      typename statements_type::batch_load_data& bl (
+        statements_.batch_load ());
+
+      for (std::size_t i (0); i != n; ++i)
+      {
+        st.position (p + i);
+        load_image ();
+        object_traits::init (bl.images_[i],
+                             object_traits::id (statements_.image ()));
+      }
+
+      st.position (p);
+      load_image ();
+
+      batch_begin_ = p;
+      batch_end_ = p + n;
+
+      // Make sure the container statements notice the new ids.
+      //
+      bl.binding_.batch = n;
+      bl.binding_.version++;
+    }
+
     template <typename T>
     void object_result_impl<T>::
     cache ()
     {
+      // SQLite allows executing other statements while this one is still
+      // active so there is no need to fetch the rows now. Instead, we only
+      // note the request and fetch the remaining rows into memory if and
+      // when size() is called.
+      //
+      cache_ = true;
     }
 
     template <typename T>
     std::size_t object_result_impl<T>::
     size ()
     {
-      throw result_not_cached ();
+      if (statement_ == 0 || !(cache_ || statement_->cached ()))
+        throw result_not_cached ();
+
+      cache_rows ();
+      return statement_->row_count ();
+    }
+
+    template <typename T>
+    void object_result_impl<T>::
+    cache_rows ()
+    {
+      if (!statement_->cached ())
+      {
+        statement_->cache ();
+
+        // The parameters are no longer needed once all the rows have
+        // been fetched.
+        //
+        params_.reset ();
+      }
     }
   }
 }
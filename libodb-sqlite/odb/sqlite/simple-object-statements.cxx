@@ -3,6 +3,8 @@
 
 #include <odb/sqlite/simple-object-statements.hxx>
 
+using namespace std;
+
 namespace odb
 {
   namespace sqlite
@@ -11,5 +13,47 @@ namespace odb
     ~object_statements_base ()
     {
     }
+
+    void
+    bind_snapshot (const bind& b, snapshot_store::object_snapshot& s)
+    {
+      if (b.buffer != 0 && b.type != bind::stream)
+      {
+        // Make sure NULL is distinct from any value.
+        //
+        char n (b.is_null != 0 && *b.is_null ? 1 : 0);
+        s.append (&n, 1);
+
+        if (n == 0)
+        {
+          switch (b.type)
+          {
+          case bind::integer:
+            {
+              s.append (b.buffer, sizeof (long long));
+              break;
+            }
+          case bind::real:
+            {
+              s.append (b.buffer, sizeof (double));
+              break;
+            }
+          case bind::text:
+          case bind::text16:
+          case bind::blob:
+          case bind::text_view:
+          case bind::blob_view:
+            {
+              s.append (*static_cast<const void* const*> (b.buffer), *b.size);
+              break;
+            }
+          case bind::stream:
+            break;
+          }
+        }
+      }
+
+      s.end_column ();
+    }
   }
 }
@@ -6,14 +6,17 @@
 
 #include <odb/pre.hxx>
 
+#include <map>
 #include <vector>
 #include <cassert>
 #include <cstddef> // std::size_t
 
 #include <odb/forward.hxx>
 #include <odb/traits.hxx>
+#include <odb/snapshot-store.hxx>
 
 #include <odb/details/shared-ptr.hxx>
+#include <odb/details/unique-ptr.hxx>
 
 #include <odb/sqlite/version.hxx>
 #include <odb/sqlite/forward.hxx>
@@ -161,7 +164,7 @@ namespace odb
       typedef T object_type;
       typedef object_traits_impl<object_type, id_sqlite> object_traits;
 
-      optimistic_data (bind*);
+      optimistic_data (bind*, std::size_t skip, unsigned long long* status);
 
       binding*
       id_image_binding () {return &id_image_binding_;}
@@ -176,12 +179,107 @@ namespace odb
     template <typename T>
     struct optimistic_data<T, false>
     {
-      optimistic_data (bind*) {}
+      optimistic_data (bind*, std::size_t, unsigned long long*) {}
 
       binding*
       id_image_binding () {return 0;}
     };
 
+    // Append the parameter value (including its NULL flag) as the next
+    // column of the object snapshot. Used to detect changed columns in
+    // objects with dirty tracking. Stream and unbound parameters are
+    // appended as empty values.
+    //
+    LIBODB_SQLITE_EXPORT void
+    bind_snapshot (const bind&, snapshot_store::object_snapshot&);
+
+    // Extra data for objects with dirty tracking (see the db dirty_tracking
+    // pragma). On update the update column values are compared to the
+    // object snapshot in the current session. Only the changed columns are
+    // then bound in the masked update binding and a separate statement is
+    // prepared and cached for each combination of such columns.
+    //
+    template <typename T, bool dirty_tracking>
+    struct dirty_data;
+
+    template <typename T>
+    struct dirty_data<T, true>
+    {
+      typedef T object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::id_type id_type;
+      typedef object_statements<object_type> statements_type;
+
+      dirty_data () {}
+
+      // Return the update statement that only sets the changed columns,
+      // the complete update statement if there is no snapshot, or NULL
+      // if there is nothing to update. The update binding should be
+      // up-to-date.
+      //
+      sqlite::update_statement*
+      update (statements_type&, const id_type&);
+
+      // Record the update column values saved by the above function as the new
+      // snapshot. Should be called after a successful update.
+      //
+      void
+      update_snapshot (statements_type&, const id_type&);
+
+      // Record the snapshot of a loaded or persisted object. If armed is
+      // true, then discard it if the current transaction is rolled back.
+      // Note that this function overwrites the object image.
+      //
+      void
+      snapshot (statements_type&,
+                const id_type&,
+                const object_type&,
+                const schema_version_migration*,
+                bool armed);
+
+      void
+      erase (statements_type&, const id_type&);
+
+      typedef
+      std::map<std::vector<bool>,
+               details::shared_ptr<sqlite::update_statement> >
+      statement_map;
+
+      snapshot_store::object_snapshot current_;
+      std::vector<bind> bind_;
+      binding binding_;
+      statement_map statements_;
+
+    private:
+      dirty_data (const dirty_data&);
+      dirty_data& operator= (const dirty_data&);
+    };
+
+    template <typename T>
+    struct dirty_data<T, false>
+    {
+      typedef T object_type;
+      typedef object_traits_impl<object_type, id_sqlite> object_traits;
+      typedef typename object_traits::id_type id_type;
+      typedef object_statements<object_type> statements_type;
+
+      sqlite::update_statement*
+      update (statements_type&, const id_type&);
+
+      void
+      update_snapshot (statements_type&, const id_type&) {}
+
+      void
+      snapshot (statements_type&,
+                const id_type&,
+                const object_type&,
+                const schema_version_migration*,
+                bool) {}
+
+      void
+      erase (statements_type&, const id_type&) {}
+    };
+
     template <typename T>
     class object_statements: public object_statements_base
     {
@@ -283,7 +381,7 @@ namespace odb
       // Object image.
       //
       image_type&
-      image () {return image_;}
+      image (std::size_t i = 0) {return images_[i].obj;}
 
       // Insert binding.
       //
@@ -330,7 +428,7 @@ namespace odb
       // Object id image and binding.
       //
       id_image_type&
-      id_image () {return id_image_;}
+      id_image (std::size_t i = 0) {return images_[i].id;}
 
       std::size_t
       id_image_version () const {return id_image_version_;}
@@ -341,6 +439,21 @@ namespace odb
       binding&
       id_image_binding () {return id_image_binding_;}
 
+      // Id images and binding for loading the containers of several
+      // objects at once (see object_traits::batch_load). Only allocated
+      // on first call.
+      //
+      struct batch_load_data;
+
+      batch_load_data&
+      batch_load ()
+      {
+        if (!batch_load_)
+          batch_load_.reset (new batch_load_data);
+
+        return *batch_load_;
+      }
+
       // Optimistic id + managed column image binding. It points to
       // the same suffix as id binding and they are always updated
       // at the same time.
@@ -394,13 +507,33 @@ namespace odb
             new (details::shared) update_statement_type (
               conn_,
               object_traits::update_statement,
-              object_traits::versioned, // Process if versioned.
+              // Process if versioned or dirty-tracked.
+              object_traits::versioned || object_traits::dirty_tracking,
               update_image_binding_));
         }
 
         return *update_;
       }
 
+      // Only available if the object supports upsert (see the upsert
+      // statement in object traits for the parameter layout).
+      //
+      update_statement_type&
+      upsert_statement ()
+      {
+        if (upsert_ == 0)
+        {
+          upsert_.reset (
+            new (details::shared) update_statement_type (
+              conn_,
+              object_traits::upsert_statement,
+              false, // Not versioned.
+              update_image_binding_));
+        }
+
+        return *upsert_;
+      }
+
       delete_statement_type&
       erase_statement ()
       {
@@ -431,6 +564,35 @@ namespace odb
         return *od_.erase_;
       }
 
+      // Dirty tracking (see dirty_data for details).
+      //
+      update_statement_type*
+      dirty_update_statement (const id_type& id)
+      {
+        return dd_.update (*this, id);
+      }
+
+      void
+      dirty_update_snapshot (const id_type& id)
+      {
+        dd_.update_snapshot (*this, id);
+      }
+
+      void
+      dirty_snapshot (const id_type& id,
+                      const object_type& obj,
+                      const schema_version_migration* svm,
+                      bool armed)
+      {
+        dd_.snapshot (*this, id, obj, svm, armed);
+      }
+
+      void
+      dirty_erase (const id_type& id)
+      {
+        dd_.erase (*this, id);
+      }
+
       // Extra (container, section) statement cache.
       //
       extra_statement_cache_type&
@@ -438,7 +600,7 @@ namespace odb
       {
         return extra_statement_cache_.get (
           conn_,
-          image_, id_image_,
+          images_[0].obj, images_[0].id,
           id_image_binding_, od_.id_image_binding ());
       }
 
@@ -469,6 +631,20 @@ namespace odb
         object_traits::readonly_column_count -
         object_traits::separate_update_column_count;
 
+      struct batch_load_data
+      {
+        batch_load_data ();
+        ~batch_load_data () {delete[] images_;}
+
+        id_image_type* images_;
+        bind bind_[id_column_count];
+        binding binding_;
+
+      private:
+        batch_load_data (const batch_load_data&);
+        batch_load_data& operator= (const batch_load_data&);
+      };
+
     private:
       object_statements (const object_statements&);
       object_statements& operator= (const object_statements&);
@@ -489,7 +665,22 @@ namespace odb
                                 image_type,
                                 id_image_type> extra_statement_cache_;
 
-      image_type image_;
+      // Object images. The id image is kept next to the object image since
+      // the update binding refers to both and, in bulk operations, the
+      // whole binding is offset by sizeof (images) for each element.
+      //
+      struct images
+      {
+        image_type obj;
+
+        // Id image binding (only used as a parameter). Uses the suffix in
+        // the update bind.
+        //
+        id_image_type id;
+      };
+
+      images images_[object_traits::batch];
+      unsigned long long status_[object_traits::batch];
 
       // Select binding.
       //
@@ -504,8 +695,8 @@ namespace odb
       binding insert_image_binding_;
       bind insert_image_bind_[insert_column_count];
 
-      // Update binding. Note that the id suffix is bound to id_image_
-      // below instead of image_ which makes this binding effectively
+      // Update binding. Note that the id suffix is bound to the id image
+      // instead of the object image which makes this binding effectively
       // bound to two images. As a result, we have to track versions
       // for both of them. If this object uses optimistic concurrency,
       // then the binding for the managed column (version, timestamp,
@@ -521,17 +712,23 @@ namespace odb
       // Id image binding (only used as a parameter). Uses the suffix in
       // the update bind.
       //
-      id_image_type id_image_;
       std::size_t id_image_version_;
       binding id_image_binding_;
 
+      details::unique_ptr<batch_load_data> batch_load_;
+
       // Extra data for objects with optimistic concurrency support.
       //
       optimistic_data<T, managed_optimistic_column_count != 0> od_;
 
+      // Extra data for objects with dirty tracking.
+      //
+      dirty_data<T, object_traits::dirty_tracking> dd_;
+
       details::shared_ptr<insert_statement_type> persist_;
       details::shared_ptr<select_statement_type> find_;
       details::shared_ptr<update_statement_type> update_;
+      details::shared_ptr<update_statement_type> upsert_;
       details::shared_ptr<delete_statement_type> erase_;
 
       // Delayed loading.
@@ -3,10 +3,12 @@
 
 #include <cstring> // std::memset
 
+#include <odb/snapshot-store.hxx>
 #include <odb/callback.hxx>
 #include <odb/exceptions.hxx>
 
 #include <odb/sqlite/connection.hxx>
+#include <odb/sqlite/transaction.hxx>
 #include <odb/sqlite/traits-calls.hxx>
 
 namespace odb
@@ -19,14 +21,174 @@ namespace odb
 
     template <typename T>
     optimistic_data<T, true>::
-    optimistic_data (bind* b)
+    optimistic_data (bind* b, std::size_t skip, unsigned long long* status)
         : id_image_binding_ (
             b,
             object_traits::id_column_count +
-            object_traits::managed_optimistic_column_count)
+            object_traits::managed_optimistic_column_count,
+            object_traits::batch,
+            skip,
+            status)
     {
     }
 
+    //
+    // dirty_data
+    //
+
+    template <typename T>
+    update_statement* dirty_data<T, true>::
+    update (statements_type& sts, const id_type& id)
+    {
+      const std::size_t n (statements_type::update_column_count);
+
+      snapshot_store* s (snapshot_store::current_pointer ());
+
+      if (s == 0)
+        return &sts.update_statement ();
+
+      binding& ub (sts.update_image_binding ());
+
+      current_.clear ();
+      for (std::size_t i (0); i != n; ++i)
+        bind_snapshot (ub.bind[i], current_);
+
+      const snapshot_store::object_snapshot* p (
+        s->object_find<T> (sts.connection ().database (), id));
+
+      if (p == 0 || p->size () != n)
+        return &sts.update_statement ();
+
+      // Figure out which columns have changed. We cannot see the values
+      // of stream columns so they are always updated. The columns that
+      // are not bound (soft-deleted) are left out as usual.
+      //
+      std::vector<bool> m (n, false);
+      std::size_t c (0);
+
+      for (std::size_t i (0); i != n; ++i)
+      {
+        const bind& b (ub.bind[i]);
+
+        if (b.buffer != 0 &&
+            (b.type == bind::stream || !current_.equal (i, *p)))
+        {
+          m[i] = true;
+          c++;
+        }
+      }
+
+      if (c == n)
+        return &sts.update_statement ();
+
+      // If nothing has changed, then there is nothing to update unless we
+      // have to increment the optimistic concurrency version.
+      //
+      if (c == 0 && statements_type::managed_optimistic_column_count == 0)
+        return 0;
+
+      // Only one statement can be executed at a time so all of them share
+      // the same masked binding which we re-initialize every time.
+      //
+      bind_.assign (ub.bind, ub.bind + ub.count);
+
+      for (std::size_t i (0); i != n; ++i)
+      {
+        if (!m[i])
+          bind_[i].buffer = 0;
+      }
+
+      binding_.bind = &bind_[0];
+      binding_.count = bind_.size ();
+      binding_.version++;
+
+      typename statement_map::iterator i (statements_.find (m));
+
+      if (i == statements_.end ())
+      {
+        details::shared_ptr<sqlite::update_statement> st (
+          new (details::shared) sqlite::update_statement (
+            sts.connection (),
+            object_traits::update_statement,
+            true, // Process to remove the unchanged columns.
+            binding_));
+
+        i = statements_.insert (
+          typename statement_map::value_type (m, st)).first;
+      }
+
+      return i->second.get ();
+    }
+
+    template <typename T>
+    void dirty_data<T, true>::
+    update_snapshot (statements_type& sts, const id_type& id)
+    {
+      if (snapshot_store* s = snapshot_store::current_pointer ())
+        s->object_insert<T> (sts.connection ().database (),
+                             id,
+                             &transaction::current ()).swap (current_);
+    }
+
+    template <typename T>
+    void dirty_data<T, true>::
+    snapshot (statements_type& sts,
+              const id_type& id,
+              const object_type& obj,
+              const schema_version_migration* svm,
+              bool armed)
+    {
+      const std::size_t n (statements_type::update_column_count);
+
+      snapshot_store* s (snapshot_store::current_pointer ());
+
+      if (s == 0)
+        return;
+
+      // Initialize the object image and the update binding the same way
+      // as the generated update() does.
+      //
+      object_traits_calls<T> tc (svm);
+
+      typename object_traits::image_type& im (sts.image ());
+
+      if (tc.init (im, obj, statement_update))
+        im.version++;
+
+      binding& ub (sts.update_image_binding ());
+
+      if (im.version != sts.update_image_version () || ub.version == 0)
+      {
+        tc.bind (ub.bind, im, statement_update);
+        sts.update_image_version (im.version);
+        ub.version++;
+      }
+
+      snapshot_store::object_snapshot& p (
+        s->object_insert<T> (sts.connection ().database (),
+                               id,
+                               armed ? &transaction::current () : 0));
+      p.clear ();
+
+      for (std::size_t i (0); i != n; ++i)
+        bind_snapshot (ub.bind[i], p);
+    }
+
+    template <typename T>
+    void dirty_data<T, true>::
+    erase (statements_type& sts, const id_type& id)
+    {
+      if (snapshot_store* s = snapshot_store::current_pointer ())
+        s->object_erase<T> (sts.connection ().database (), id);
+    }
+
+    template <typename T>
+    update_statement* dirty_data<T, false>::
+    update (statements_type& sts, const id_type&)
+    {
+      return &sts.update_statement ();
+    }
+
     //
     // object_statements
     //
@@ -37,26 +199,62 @@ namespace odb
     {
     }
 
+    template <typename T>
+    object_statements<T>::batch_load_data::
+    batch_load_data ()
+        : images_ (new id_image_type[object_traits::batch_load]),
+          binding_ (bind_,
+                    id_column_count,
+                    object_traits::batch_load,
+                    sizeof (id_image_type),
+                    0)
+    {
+      std::memset (bind_, 0, sizeof (bind_));
+
+      // The bind refers to the buffers of the first image and the others
+      // are reached using the binding skip.
+      //
+      object_traits::bind (bind_, images_[0]);
+
+      for (std::size_t i (0); i != object_traits::batch_load; ++i)
+        images_[i].version = 0;
+    }
+
     template <typename T>
     object_statements<T>::
     object_statements (connection_type& conn)
         : object_statements_base (conn),
           select_image_binding_ (select_image_bind_, select_column_count),
-          insert_image_binding_ (insert_image_bind_, insert_column_count),
+          insert_image_binding_ (insert_image_bind_,
+                                 insert_column_count,
+                                 object_traits::batch,
+                                 sizeof (images),
+                                 status_),
           update_image_binding_ (update_image_bind_,
                                  update_column_count + id_column_count +
-                                 managed_optimistic_column_count),
+                                 managed_optimistic_column_count,
+                                 object_traits::batch,
+                                 sizeof (images),
+                                 status_),
           id_image_binding_ (update_image_bind_ + update_column_count,
-                             id_column_count),
-          od_ (update_image_bind_ + update_column_count)
+                             id_column_count,
+                             object_traits::batch,
+                             sizeof (images),
+                             status_),
+          od_ (update_image_bind_ + update_column_count,
+               sizeof (images),
+               status_)
     {
-      image_.version = 0;
+      for (std::size_t i (0); i < object_traits::batch; ++i)
+      {
+        images_[i].obj.version = 0;
+        images_[i].id.version = 0;
+      }
+
       select_image_version_ = 0;
       insert_image_version_ = 0;
       update_image_version_ = 0;
       update_id_image_version_ = 0;
-
-      id_image_.version = 0;
       id_image_version_ = 0;
 
       std::memset (insert_image_bind_, 0, sizeof (insert_image_bind_));
@@ -107,6 +305,9 @@ namespace odb
           if (!delayed_.empty ())
             load_delayed_<STS> (svm);
 
+          if (object_traits::dirty_tracking)
+            dirty_snapshot (l.id, *l.obj, svm, false);
+
           // Temporarily unlock the statement for the post_load call so that
           // it can load objects of this type recursively. This is safe to do
           // because we have completely loaded the current object. Also the
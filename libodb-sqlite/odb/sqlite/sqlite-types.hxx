@@ -16,17 +16,28 @@ namespace odb
     // The SQLite parameter/result binding. This data structures is modelled
     // after MYSQL_BIND from MySQL.
     //
+    // Note that for the text, text16, and blob types the buffer points to
+    // the pointer to the data rather than to the data itself. This way
+    // the binding stays valid if the data buffer is reallocated and can
+    // also be offset to refer to another image in an image array (used
+    // in bulk operations).
+    //
     struct bind
     {
       enum buffer_type
       {
         integer, // Buffer is long long; size, capacity, truncated are unused.
         real,    // Buffer is double; size, capacity, truncated are unused.
-        text,    // Buffer is a UTF-8 char array.
-        text16,  // Buffer is a UTF-16 2-byte char array (sizes in bytes).
-        blob,    // Buffer is a char array.
-        stream   // Buffer is stream_buffers. Size specifies the BLOB size
+        text,    // Buffer is a pointer to a UTF-8 char array.
+        text16,  // Buffer is a pointer to a UTF-16 2-byte char array (sizes
+                 // in bytes).
+        blob,    // Buffer is a pointer to a char array.
+        stream,  // Buffer is stream_buffers. Size specifies the BLOB size
                  // (input only). Capacity and truncated unused.
+        text_view, // Same as text for input. For output, instead of copying
+                   // the data, the pointer is set to point to it. Capacity
+                   // and truncated are unused. See view_buffer below.
+        blob_view  // Same as text_view but for BLOB.
       };
 
       buffer_type type;
@@ -37,6 +48,59 @@ namespace odb
       bool* truncated;
     };
 
+    // Image type for the text_view and blob_view bindings. It has the same
+    // interface as details::buffer (as used by the generated code) but
+    // instead of holding the data it points to the data owned by someone
+    // else: the value when used as a parameter and the statement when
+    // used as a result. In the latter case, the data is only valid until
+    // the next row is fetched or the statement is re-executed.
+    //
+    class view_buffer
+    {
+    public:
+      view_buffer (): data_ (0) {}
+
+      const char*
+      data () const
+      {
+        return static_cast<const char*> (data_);
+      }
+
+      void
+      data (const void* d)
+      {
+        data_ = const_cast<void*> (d);
+      }
+
+      void**
+      data_ptr ()
+      {
+        return &data_;
+      }
+
+      const void* const*
+      data_ptr () const
+      {
+        return &data_;
+      }
+
+      // There is nothing to grow.
+      //
+      std::size_t
+      capacity () const
+      {
+        return 0;
+      }
+
+      void
+      capacity (std::size_t, std::size_t = 0)
+      {
+      }
+
+    private:
+      void* data_;
+    };
+
     // The "out" values should be set in set_image() to point to
     // variables that will be receiving the data. The "in" values
     // are used in set_value() and contain the data that needs to
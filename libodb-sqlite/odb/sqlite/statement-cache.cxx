@@ -0,0 +1,91 @@
+// file      : odb/sqlite/statement-cache.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/sqlite/statement-cache.hxx>
+
+namespace odb
+{
+  using namespace details;
+
+  namespace sqlite
+  {
+    shared_ptr<select_statement> statement_cache::
+    find_query (const std::string& text,
+                bool process,
+                bool optimize,
+                binding& param,
+                binding& result)
+    {
+      // Query statements may be bound to the images of the object
+      // statements so we have to clear them along with the rest if
+      // the database version has changed.
+      //
+      if (version_seq_ != conn_.database ().schema_version_sequence ())
+        clear ();
+
+      query_map::iterator i (
+        query_capacity_ != 0
+        ? query_map_.find (query_key (&result, text))
+        : query_map_.end ());
+
+      if (i != query_map_.end ())
+      {
+        query_list::iterator j (i->second);
+
+        // If we are the only ones holding this statement, then it is not
+        // used by any result and can be re-executed.
+        //
+        if (j->statement.count () == 1)
+        {
+          query_hits_++;
+          query_list_.splice (query_list_.begin (), query_list_, j);
+          j->statement->param (param);
+          return j->statement;
+        }
+      }
+
+      query_misses_++;
+
+      shared_ptr<select_statement> r (
+        new (shared) select_statement (
+          conn_, text, process, optimize, param, result));
+
+      if (query_capacity_ != 0 && i == query_map_.end ())
+      {
+        if (query_list_.size () == query_capacity_)
+        {
+          query_map_.erase (query_list_.back ().key);
+          query_list_.pop_back ();
+        }
+
+        query_entry e;
+        e.key = query_key (&result, text);
+        e.statement = r;
+
+        query_list_.push_front (e);
+        query_map_.insert (
+          query_map::value_type (e.key, query_list_.begin ()));
+      }
+
+      return r;
+    }
+
+    void statement_cache::
+    query_cache_capacity (std::size_t n)
+    {
+      for (; query_list_.size () > n; query_list_.pop_back ())
+        query_map_.erase (query_list_.back ().key);
+
+      query_capacity_ = n;
+    }
+
+    void statement_cache::
+    clear ()
+    {
+      query_map_.clear ();
+      query_list_.clear ();
+      map_.clear ();
+      version_seq_ = conn_.database ().schema_version_sequence ();
+    }
+  }
+}
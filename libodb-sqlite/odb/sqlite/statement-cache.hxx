@@ -7,6 +7,10 @@
 #include <odb/pre.hxx>
 
 #include <map>
+#include <list>
+#include <string>
+#include <utility>  // std::pair
+#include <cstddef>  // std::size_t
 #include <typeinfo>
 
 #include <odb/forward.hxx>
@@ -31,7 +35,10 @@ namespace odb
     public:
       statement_cache (connection& conn)
           : conn_ (conn),
-            version_seq_ (conn_.database ().schema_version_sequence ()) {}
+            version_seq_ (conn_.database ().schema_version_sequence ()),
+            query_capacity_ (32),
+            query_hits_ (0),
+            query_misses_ (0) {}
 
       template <typename T>
       typename object_traits_impl<T, id_sqlite>::statements_type&
@@ -41,14 +48,87 @@ namespace odb
       view_statements<T>&
       find_view ();
 
+      // Return a select statement for a dynamic (non-prepared) object or
+      // view query. The arguments are the same as for the select_statement
+      // constructor. Statements are cached by the query text and the result
+      // binding and the least recently used statement is evicted once the
+      // cache capacity is reached. A cached statement is re-executed with
+      // the passed parameter binding. If the cached statement is still in
+      // use (for example, by a result that hasn't been destroyed), then a
+      // new, uncached statement is returned.
+      //
+      details::shared_ptr<select_statement>
+      find_query (const std::string& text,
+                  bool process,
+                  bool optimize,
+                  binding& param,
+                  binding& result);
+
+      // Maximum number of cached query statements. The default is 32.
+      // Setting the capacity to 0 disables caching.
+      //
+      std::size_t
+      query_cache_capacity () const
+      {
+        return query_capacity_;
+      }
+
+      void
+      query_cache_capacity (std::size_t);
+
+      std::size_t
+      query_cache_size () const
+      {
+        return query_list_.size ();
+      }
+
+      // Query statement cache statistics.
+      //
+      unsigned long long
+      query_cache_hits () const
+      {
+        return query_hits_;
+      }
+
+      unsigned long long
+      query_cache_misses () const
+      {
+        return query_misses_;
+      }
+
+    private:
+      void
+      clear ();
+
     private:
       typedef std::map<const std::type_info*,
                        details::shared_ptr<statements_base>,
                        details::type_info_comparator> map;
 
+      // Query statements are keyed by the result binding and the query
+      // text. The list is ordered from the most to the least recently
+      // used statement.
+      //
+      typedef std::pair<const binding*, std::string> query_key;
+
+      struct query_entry
+      {
+        query_key key;
+        details::shared_ptr<select_statement> statement;
+      };
+
+      typedef std::list<query_entry> query_list;
+      typedef std::map<query_key, query_list::iterator> query_map;
+
       connection& conn_;
       unsigned int version_seq_;
       map map_;
+
+      std::size_t query_capacity_;
+      query_list query_list_;
+      query_map query_map_;
+      unsigned long long query_hits_;
+      unsigned long long query_misses_;
     };
   }
 }
@@ -21,10 +21,7 @@ namespace odb
       // the old schema.
       //
       if (version_seq_ != conn_.database ().schema_version_sequence ())
-      {
-        map_.clear ();
-        version_seq_ = conn_.database ().schema_version_sequence ();
-      }
+        clear ();
 
       map::iterator i (map_.find (&typeid (T)));
 
@@ -1,9 +1,25 @@
 // file      : odb/sqlite/statement.cxx
 // license   : GNU GPL v2; see accompanying LICENSE file
 
+#include <new> // std::bad_alloc
+
 #include <odb/tracer.hxx>
 #include <odb/exceptions.hxx> // object_not_persistent
 
+#include <odb/details/config.hxx> // ODB_CXX11
+#include <odb/details/lock.hxx>
+#include <odb/details/mutex.hxx>
+#include <odb/details/unused.hxx>
+#include <odb/details/condition.hxx>
+
+#ifndef ODB_THREADS_NONE
+#  include <odb/details/thread.hxx>
+#endif
+
+#ifdef ODB_CXX11
+#  include <chrono>
+#endif
+
 #include <odb/sqlite/database.hxx>
 #include <odb/sqlite/statement.hxx>
 #include <odb/sqlite/connection.hxx>
@@ -17,6 +33,32 @@ namespace odb
 {
   namespace sqlite
   {
+    // Offset a binding pointer to refer to an image in an image array.
+    //
+    template <typename T>
+    static inline T*
+    offset (T* p, size_t o)
+    {
+      return reinterpret_cast<T*> (reinterpret_cast<char*> (p) + o);
+    }
+
+    // Monotonic time in nanoseconds for execution statistics. Without
+    // C++11 we have no portable clock so the duration is not measured.
+    //
+    static inline unsigned long long
+    now ()
+    {
+#ifdef ODB_CXX11
+      using namespace std::chrono;
+
+      return static_cast<unsigned long long> (
+        duration_cast<nanoseconds> (
+          steady_clock::now ().time_since_epoch ()).count ());
+#else
+      return 0;
+#endif
+    }
+
     // statement
     //
 
@@ -46,6 +88,32 @@ namespace odb
       reset ();
     }
 
+    void statement::
+    trace_end ()
+    {
+      if (odb::tracer* t = trace_)
+      {
+        trace_ = 0;
+        t->executed (conn_, *this, trace_stats_);
+      }
+    }
+
+    int statement::
+    step ()
+    {
+      if (trace_ == 0)
+        return sqlite3_step (stmt_);
+
+      unsigned long long s (now ());
+      int e (sqlite3_step (stmt_));
+      trace_stats_.duration += now () - s;
+
+      if (e == SQLITE_BUSY)
+        trace_stats_.busy++;
+
+      return e;
+    }
+
     void statement::
     init (const char* text,
           std::size_t text_size,
@@ -54,6 +122,8 @@ namespace odb
           bool optimize)
     {
       active_ = false;
+      trace_ = 0;
+      trace_stats_ = odb::tracer::execution_stats ();
 
       string tmp1;
       if (proc != 0)
@@ -178,14 +248,14 @@ namespace odb
     }
 
     bool statement::
-    bind_param (const bind* p, size_t n)
+    bind_param (const bind* p, size_t n, size_t o, size_t f)
     {
       int e (SQLITE_OK);
       bool r (false);
 
       // SQLite parameters are counted from 1.
       //
-      for (size_t i (0), j (1); e == SQLITE_OK && i < n; ++i)
+      for (size_t i (0), j (f); e == SQLITE_OK && i < n; ++i)
       {
         const bind& b (p[i]);
 
@@ -194,17 +264,19 @@ namespace odb
 
         int c (static_cast<int> (j++));
 
-        if (b.is_null != 0 && *b.is_null)
+        if (b.is_null != 0 && *offset (b.is_null, o))
         {
           e = sqlite3_bind_null (stmt_, c);
           continue;
         }
 
+        void* buf (offset (static_cast<char*> (b.buffer), o));
+
         switch (b.type)
         {
         case bind::integer:
           {
-            long long v (*static_cast<long long*> (b.buffer));
+            long long v (*static_cast<long long*> (buf));
 
             e = sqlite3_bind_int64 (stmt_,
                                     c,
@@ -219,16 +291,17 @@ namespace odb
           }
         case bind::real:
           {
-            double v (*static_cast<double*> (b.buffer));
+            double v (*static_cast<double*> (buf));
             e = sqlite3_bind_double (stmt_, c, v);
             break;
           }
         case bind::text:
+        case bind::text_view:
           {
             e = sqlite3_bind_text (stmt_,
                                    c,
-                                   static_cast<const char*> (b.buffer),
-                                   static_cast<int> (*b.size),
+                                   *static_cast<const char**> (buf),
+                                   static_cast<int> (*offset (b.size, o)),
                                    SQLITE_STATIC);
             break;
           }
@@ -236,17 +309,18 @@ namespace odb
           {
             e = sqlite3_bind_text16 (stmt_,
                                      c,
-                                     b.buffer,
-                                     static_cast<int> (*b.size),
+                                     *static_cast<const void**> (buf),
+                                     static_cast<int> (*offset (b.size, o)),
                                      SQLITE_STATIC);
             break;
           }
         case bind::blob:
+        case bind::blob_view:
           {
             e = sqlite3_bind_blob (stmt_,
                                    c,
-                                   b.buffer,
-                                   static_cast<int> (*b.size),
+                                   *static_cast<const void**> (buf),
+                                   static_cast<int> (*offset (b.size, o)),
                                    SQLITE_STATIC);
             break;
           }
@@ -255,7 +329,7 @@ namespace odb
 #if SQLITE_VERSION_NUMBER >= 3004000
             e = sqlite3_bind_zeroblob (stmt_,
                                        c,
-                                       static_cast<int> (*b.size));
+                                       static_cast<int> (*offset (b.size, o)));
             r = true;
 #else
             assert (false);
@@ -272,12 +346,16 @@ namespace odb
     }
 
     bool statement::
-    bind_result (const bind* p, size_t count, bool truncated)
+    bind_result (const bind* p,
+                 size_t count,
+                 bool truncated,
+                 size_t first,
+                 bool partial)
     {
       bool r (true);
       int col_count (sqlite3_data_count (stmt_));
 
-      int col (0);
+      int col (static_cast<int> (first));
       for (size_t i (0); i != count && col != col_count; ++i)
       {
         const bind& b (p[i]);
@@ -353,7 +431,25 @@ namespace odb
               continue;
             }
 
-            memcpy (b.buffer, d, *b.size);
+            memcpy (*static_cast<void**> (b.buffer), d, *b.size);
+            break;
+          }
+        case bind::text_view:
+        case bind::blob_view:
+          {
+            // Point the image directly to the column data. It stays valid
+            // until the next step or reset of the statement.
+            //
+            const void* d (
+              b.type == bind::text_view
+              ? static_cast<const void*> (sqlite3_column_text (stmt_, c))
+              : sqlite3_column_blob (stmt_, c));
+            *b.size = static_cast<size_t> (sqlite3_column_bytes (stmt_, c));
+
+            // Empty BLOB comes back as NULL pointer (see load_cached() for
+            // why we don't want that).
+            //
+            *static_cast<const void**> (b.buffer) = d != 0 ? d : "";
             break;
           }
         case bind::stream:
@@ -389,13 +485,13 @@ namespace odb
       // of this assertion is a native view with a number of data members
       // not matching the number of columns in the SELECT-list.
       //
-      assert (col == col_count);
+      assert (partial ? col <= col_count : col == col_count);
 
       return r;
     }
 
     void statement::
-    stream_param (const bind* p, size_t n, const stream_data& d)
+    stream_param (const bind* p, size_t n, const stream_data& d, size_t o)
     {
       // Code similar to bind_param().
       //
@@ -408,7 +504,8 @@ namespace odb
 
         int c (static_cast<int> (j++));
 
-        if ((b.is_null != 0 && *b.is_null) || b.type != bind::stream)
+        if ((b.is_null != 0 && *offset (b.is_null, o)) ||
+            b.type != bind::stream)
           continue;
 
         // Get column name.
@@ -416,7 +513,8 @@ namespace odb
         const char* col (sqlite3_bind_parameter_name (stmt_, c));
         assert (col != 0); // Statement doesn't contain column name.
 
-        stream_buffers& sb (*static_cast<stream_buffers*> (b.buffer));
+        stream_buffers& sb (
+          *offset (static_cast<stream_buffers*> (b.buffer), o));
 
         *sb.db.out = d.db;
         *sb.table.out = d.table;
@@ -425,6 +523,27 @@ namespace odb
       }
     }
 
+    bool statement::
+    batch_error (int e, size_t p, multiple_exceptions& mex)
+    {
+      // Some errors (for example, SQLITE_FULL or SQLITE_IOERR) cause SQLite
+      // to automatically roll the transaction back in which case there is
+      // no use continuing with the rest of the batch.
+      //
+      bool fatal (sqlite3_get_autocommit (conn_.handle ()) != 0);
+
+      try
+      {
+        translate_error (e, conn_);
+      }
+      catch (const odb::exception& ex)
+      {
+        mex.insert (p, ex, fatal);
+      }
+
+      return fatal;
+    }
+
     inline void
     update_hook (void* v, const char* db, const char* table, long long rowid)
     {
@@ -493,6 +612,8 @@ namespace odb
             (t = conn_.tracer ()) ||
             (t = conn_.database ().tracer ()))
           t->execute (conn_, *this);
+
+        trace_start (t);
       }
 
       unsigned long long r (0);
@@ -503,21 +624,32 @@ namespace odb
 #ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
       // Only the first call to sqlite3_step() can return SQLITE_LOCKED.
       //
-      while ((e = sqlite3_step (stmt_)) == SQLITE_LOCKED)
+      while ((e = step ()) == SQLITE_LOCKED)
       {
         if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
           break;
 
         sqlite3_reset (stmt_);
-        conn_.wait ();
+        wait ();
       }
 #else
-      e = sqlite3_step (stmt_);
+      e = step ();
 #endif
 
-      for (; e == SQLITE_ROW; e = sqlite3_step (stmt_))
+      for (; e == SQLITE_ROW; e = step ())
         r++;
 
+      if (trace_ != 0)
+      {
+        if (result_set_)
+          trace_stats_.rows_fetched = r;
+        else if (e == SQLITE_DONE)
+          trace_stats_.rows_affected =
+            static_cast<unsigned long long> (sqlite3_changes (h));
+
+        trace_end ();
+      }
+
       // sqlite3_step() will return a detailed error code only if we used
       // sqlite3_prepare_v2(). Otherwise, sqlite3_reset() returns the
       // error.
@@ -564,6 +696,64 @@ namespace odb
     // select_statement
     //
 
+    // Prefetch ring buffer. The rows are filled by the helper thread at
+    // [head, head + count) and the current row (if busy) is owned by the
+    // caller.
+    //
+    struct select_statement::prefetch_data
+    {
+      struct row
+      {
+        vector<cached_value> values;
+        vector<char> data;
+      };
+
+      prefetch_data (size_t n, const binding& r)
+          : binds (r.bind, r.bind + r.count),
+            rows (n),
+            head (0), count (0), current (0), busy (false),
+            stop (false), finished (false), code (SQLITE_OK),
+            producer_waiting (false), consumer_waiting (false),
+            space (mutex), ready (mutex)
+      {
+      }
+
+      // Copy of the result binding since the original can be changed by
+      // the caller (for example, when the image grows).
+      //
+      vector<bind> binds;
+
+      vector<row> rows;
+      size_t head;
+      size_t count;
+      size_t current;
+      bool busy;
+
+      bool stop;
+      bool finished;
+      int code; // Final sqlite3_step() result or SQLITE_OK if stopped.
+
+      // Only signal the other side if it is waiting.
+      //
+      bool producer_waiting;
+      bool consumer_waiting;
+
+      details::mutex mutex;
+      details::condition space; // Signalled when a row is freed.
+      details::condition ready; // Signalled when a row is fetched.
+
+#ifndef ODB_THREADS_NONE
+      details::unique_ptr<details::thread> thread;
+#endif
+    };
+
+    select_statement::
+    ~select_statement ()
+    {
+      if (prefetch_)
+        stop_prefetch ();
+    }
+
     select_statement::
     select_statement (connection_type& conn,
                       const string& text,
@@ -575,7 +765,12 @@ namespace odb
                      text, statement_select,
                      (process ? &result : 0), optimize),
           param_ (&param),
-          result_ (result)
+          result_ (result),
+          loaded_ (false),
+          cached_ (false),
+          key_count_ (0),
+          wide_ (false),
+          redirect_ (0)
     {
     }
 
@@ -590,7 +785,12 @@ namespace odb
                      text, statement_select,
                      (process ? &result : 0), optimize),
           param_ (&param),
-          result_ (result)
+          result_ (result),
+          loaded_ (false),
+          cached_ (false),
+          key_count_ (0),
+          wide_ (false),
+          redirect_ (0)
     {
     }
 
@@ -604,7 +804,12 @@ namespace odb
                      text, statement_select,
                      (process ? &result : 0), optimize),
           param_ (0),
-          result_ (result)
+          result_ (result),
+          loaded_ (false),
+          cached_ (false),
+          key_count_ (0),
+          wide_ (false),
+          redirect_ (0)
     {
     }
 
@@ -618,13 +823,31 @@ namespace odb
                      text, statement_select,
                      (process ? &result : 0), optimize),
           param_ (0),
-          result_ (result)
+          result_ (result),
+          loaded_ (false),
+          cached_ (false),
+          key_count_ (0),
+          wide_ (false),
+          redirect_ (0)
     {
     }
 
     void select_statement::
     execute ()
     {
+      if (redirect_ != 0)
+      {
+        done_ = false;
+        row_ = false;
+        loaded_ = false;
+        return;
+      }
+
+      if (prefetch_)
+        stop_prefetch ();
+
+      trace_end ();
+
       if (active ())
         reset ();
 
@@ -634,12 +857,53 @@ namespace odb
             (t = conn_.tracer ()) ||
             (t = conn_.database ().tracer ()))
           t->execute (conn_, *this);
+
+        trace_start (t);
       }
 
       done_ = false;
+      row_ = false;
+      loaded_ = false;
+      rows_ = 0;
+
+      if (cached_)
+      {
+        values_.clear ();
+        data_.clear ();
+        cached_ = false;
+      }
 
       if (param_ != 0)
-        bind_param (param_->bind, param_->count);
+      {
+        if (key_count_ != 0)
+        {
+          // Bind the valid images and NULL for the rest of the parameters
+          // (NULL never matches anything). Also save the key values for
+          // select_key().
+          //
+          sqlite3_clear_bindings (stmt_);
+          keys_.clear ();
+
+          const binding& k (
+            param_->prefetch != 0 ? *param_->prefetch : *param_);
+          size_t n (param_->prefetch != 0 ? k.batch : 1);
+
+          for (size_t i (0); i != n; ++i)
+          {
+            size_t o (i * k.skip);
+            bind_param (k.bind, k.count, o, i * key_count_ + 1);
+
+            for (size_t j (0); j != key_count_; ++j)
+            {
+              cached_value v;
+              param_value (k.bind[j], o, v);
+              keys_.push_back (v);
+            }
+          }
+        }
+        else
+          bind_param (param_->bind, param_->count);
+      }
 
       active (true);
     }
@@ -647,182 +911,1042 @@ namespace odb
     void select_statement::
     free_result ()
     {
+      if (loaded_)
+        pin_views ();
+
+      if (redirect_ != 0)
+      {
+        redirect_ = 0;
+        done_ = true;
+        return;
+      }
+
+      if (prefetch_)
+        stop_prefetch ();
+
+      trace_end ();
       reset ();
       done_ = true;
+
+      // In the keyed mode the cached rows are reused by select_key().
+      //
+      if (cached_ && key_count_ == 0)
+      {
+        // Release the memory since the statement can be cached.
+        //
+        vector<cached_value> ().swap (values_);
+        vector<char> ().swap (data_);
+      }
     }
 
-    bool select_statement::
-    next ()
+    void select_statement::
+    cache ()
     {
+      if (cached_)
+        return;
+
+      if (loaded_)
+        pin_views ();
+
+      bool row (row_);
+      size_t n (0);
+
       if (!done_)
       {
-        int e;
+        if (prefetch_)
+          n = cache_prefetched ();
+        else if (row_)
+        {
+          cache_row ();
+          n++;
+        }
 
-#ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
-        sqlite3* h (conn_.handle ());
-        while ((e = sqlite3_step (stmt_)) == SQLITE_LOCKED)
+        for (; next (); n++)
+          cache_row ();
+      }
+
+      cached_ = true;
+      cache_size_ = n;
+      position_ = row ? 1 : 0;
+      done_ = n == 0;
+
+      if (key_count_ != 0)
+      {
+        // Find the first row of each group of rows with the same key.
+        //
+        groups_.clear ();
+
+        for (size_t i (0); i != n; ++i)
         {
-          if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
-            break;
+          bool f (i == 0);
 
-          sqlite3_reset (stmt_);
-          conn_.wait ();
+          for (size_t j (0); !f && j != key_count_; ++j)
+            f = !key_equal (values_[i * columns_ + j],
+                            values_[(i - 1) * columns_ + j],
+                            param_->bind[j].type);
+
+          if (f)
+            groups_.push_back (i);
         }
-#else
-        e = sqlite3_step (stmt_);
-#endif
 
-        if (e != SQLITE_ROW)
+        groups_.push_back (n);
+      }
+    }
+
+    bool select_statement::
+    select_key ()
+    {
+      assert (key_count_ != 0 && cached_);
+
+      // Find the current parameter values among those the statement was
+      // executed with.
+      //
+      const cached_value* kv (0);
+      {
+        size_t n (keys_.size () / key_count_);
+
+        for (size_t i (0); kv == 0 && i != n; ++i)
         {
-          done_ = true;
+          bool e (true);
 
-          // sqlite3_step() will return a detailed error code only if we used
-          // sqlite3_prepare_v2(). Otherwise, sqlite3_reset() returns the
-          // error.
-          //
-#if SQLITE_VERSION_NUMBER >= 3003011
-          reset ();
+          for (size_t j (0); e && j != key_count_; ++j)
+          {
+            const bind& b (param_->bind[j]);
 
-          if (e != SQLITE_DONE)
-#else
-          e = reset ();
+            cached_value v;
+            param_value (b, 0, v);
+            e = key_equal (keys_[i * key_count_ + j], v, b.type);
+            data_.resize (v.offset); // Discard the value data.
+          }
 
-          if (e != SQLITE_OK)
-#endif
-            translate_error (e, conn_);
+          if (e)
+            kv = &keys_[i * key_count_];
         }
+
+        if (kv == 0)
+          return false;
       }
 
-      return !done_;
-    }
+      // Find the group of rows for this key. It is empty if there are no
+      // rows.
+      //
+      position_ = cache_size_ = 0;
 
-    select_statement::result select_statement::
-    load ()
-    {
-      if (done_)
-        return no_data;
+      for (size_t g (0); g + 1 < groups_.size (); ++g)
+      {
+        const cached_value* v (&values_[groups_[g] * columns_]);
 
-      return bind_result (result_.bind, result_.count) ? success : truncated;
-    }
+        bool e (true);
+        for (size_t j (0); e && j != key_count_; ++j)
+          e = key_equal (v[j], kv[j], param_->bind[j].type);
 
-    void select_statement::
-    reload ()
-    {
-      assert (!done_);
+        if (e)
+        {
+          position_ = groups_[g];
+          cache_size_ = groups_[g + 1];
+          break;
+        }
+      }
 
-      if (!bind_result (result_.bind, result_.count, true))
-        assert (false);
+      done_ = position_ == cache_size_;
+      return true;
     }
 
-    // insert_statement
-    //
-
-    insert_statement::
-    insert_statement (connection_type& conn,
-                      const string& text,
-                      bool process,
-                      binding& param,
-                      binding* returning)
-        : statement (conn,
-                     text, statement_insert,
-                     (process ? &param : 0), false),
-          param_ (param),
-          returning_ (returning)
+    void select_statement::
+    cache_row ()
     {
+      columns_ = cache_row (result_.bind, result_.count, values_, data_);
     }
 
-    insert_statement::
-    insert_statement (connection_type& conn,
-                      const char* text,
-                      bool process,
-                      binding& param,
-                      binding* returning)
-        : statement (conn,
-                     text, statement_insert,
-                     (process ? &param : 0), false),
-          param_ (param),
-          returning_ (returning)
+    size_t select_statement::
+    cache_row (const bind* bs, size_t count,
+               vector<cached_value>& values, vector<char>& data)
     {
-    }
+      int col_count (sqlite3_data_count (stmt_));
 
-    bool insert_statement::
-    execute ()
-    {
+      // In the keyed mode the key columns come first and have the same
+      // types as the parameters.
+      //
+      int col (0);
+      size_t n (0);
+      for (size_t i (0); i != key_count_; ++i, ++n)
       {
-        odb::tracer* t;
-        if ((t = conn_.main_connection ().transaction_tracer ()) ||
-            (t = conn_.tracer ()) ||
-            (t = conn_.database ().tracer ()))
-          t->execute (conn_, *this);
+        cached_value v;
+        cache_value (param_->bind[i], col++, v, data);
+        values.push_back (v);
       }
 
-      sqlite3* h (conn_.handle ());
-      bool stream (bind_param (param_.bind, param_.count));
+      for (size_t i (0); i != count && col != col_count; ++i)
+      {
+        const bind& b (bs[i]);
 
-      stream_data sd;
-      if (stream)
-        sqlite3_update_hook (h, &odb_sqlite_update_hook, &sd);
+        if (b.buffer == 0) // Skip NULL entries.
+          continue;
 
-      int e;
+        int c (col++);
 
-#ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
-      while ((e = sqlite3_step (stmt_)) == SQLITE_LOCKED)
-      {
-        if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
-          break;
+        if (b.type == bind::stream)
+          col++; // Skip ROWID value that follows.
 
-        sqlite3_reset (stmt_);
-        conn_.wait ();
+        cached_value v;
+        cache_value (b, c, v, data);
+        values.push_back (v);
+        n++;
       }
-#else
-      e = sqlite3_step (stmt_);
-#endif
 
-      if (stream)
-        sqlite3_update_hook (h, 0, 0); // Clear the hook.
+      assert (wide_ ? col <= col_count : col == col_count);
+      return n;
+    }
 
-      // sqlite3_step() will return a detailed error code only if we used
-      // sqlite3_prepare_v2(). Otherwise, sqlite3_reset() returns the
-      // error.
-      //
-#if SQLITE_VERSION_NUMBER >= 3003011
-      sqlite3_reset (stmt_);
+    void select_statement::
+    cache_value (const bind& b, int c, cached_value& v, vector<char>& data)
+    {
+      v.null = sqlite3_column_type (stmt_, c) == SQLITE_NULL;
+      v.integer = 0;
+      v.real = 0;
+      v.offset = data.size ();
+      v.size = 0;
 
-      if (e != SQLITE_DONE)
-#else
-      e = sqlite3_reset (stmt_);
+      if (v.null)
+        return;
 
-      if (e != SQLITE_OK)
-#endif
+      switch (b.type)
       {
-        // SQLITE_CONSTRAINT error code covers more than just a duplicate
-        // primary key. Unfortunately, there is nothing more precise that
-        // we can use (even sqlite3_errmsg() returns generic "constraint
-        // failed"). But an auto-assigned object id should never cause a
-        // duplicate primary key.
-        //
-        if (returning_ == 0 && e == SQLITE_CONSTRAINT)
-          return false;
-        else
-          translate_error (e, conn_);
+      case bind::integer:
+        {
+          v.integer = static_cast<long long> (sqlite3_column_int64 (stmt_, c));
+          break;
+        }
+      case bind::real:
+        {
+          v.real = sqlite3_column_double (stmt_, c);
+          break;
+        }
+      case bind::text:
+      case bind::text16:
+      case bind::blob:
+        {
+          // Same as in bind_result().
+          //
+          const char* d;
+
+          if (b.type != bind::text16)
+          {
+            d = static_cast<const char*> (
+              b.type == bind::text
+              ? sqlite3_column_text (stmt_, c)
+              : sqlite3_column_blob (stmt_, c));
+            v.size = static_cast<size_t> (sqlite3_column_bytes (stmt_, c));
+          }
+          else
+          {
+            d = static_cast<const char*> (sqlite3_column_text16 (stmt_, c));
+            v.size = static_cast<size_t> (sqlite3_column_bytes16 (stmt_, c));
+          }
+
+          data.insert (data.end (), d, d + v.size);
+          break;
+        }
+      case bind::text_view:
+      case bind::blob_view:
+        {
+          const char* d (
+            static_cast<const char*> (
+              b.type == bind::text_view
+              ? static_cast<const void*> (sqlite3_column_text (stmt_, c))
+              : sqlite3_column_blob (stmt_, c)));
+          v.size = static_cast<size_t> (sqlite3_column_bytes (stmt_, c));
+
+          data.insert (data.end (), d, d + v.size);
+          break;
+        }
+      case bind::stream:
+        {
+          // Store the database, table, and column names as a sequence of
+          // '\0'-terminated strings.
+          //
+#ifdef LIBODB_SQLITE_HAVE_COLUMN_METADATA
+          const char* ns[3] = {
+            sqlite3_column_database_name (stmt_, c),
+            sqlite3_column_table_name (stmt_, c),
+            sqlite3_column_origin_name (stmt_, c)};
+
+          for (size_t j (0); j != 3; ++j)
+          {
+            data.insert (data.end (), ns[j], ns[j] + strlen (ns[j]));
+            data.push_back ('\0');
+          }
+#else
+          assert (false);
+#endif
+          v.integer = static_cast<long long> (
+            sqlite3_column_int64 (stmt_, c + 1));
+          break;
+        }
+      }
+    }
+
+    void select_statement::
+    param_value (const bind& b, size_t o, cached_value& v)
+    {
+      v.null = b.is_null != 0 && *offset (b.is_null, o);
+      v.integer = 0;
+      v.real = 0;
+      v.offset = data_.size ();
+      v.size = 0;
+
+      if (v.null)
+        return;
+
+      const void* buf (offset (static_cast<char*> (b.buffer), o));
+
+      switch (b.type)
+      {
+      case bind::integer:
+        {
+          v.integer = *static_cast<const long long*> (buf);
+          break;
+        }
+      case bind::real:
+        {
+          v.real = *static_cast<const double*> (buf);
+          break;
+        }
+      case bind::text:
+      case bind::text16:
+      case bind::blob:
+      case bind::text_view:
+      case bind::blob_view:
+        {
+          const char* d (*static_cast<const char* const*> (buf));
+          v.size = *offset (b.size, o);
+          data_.insert (data_.end (), d, d + v.size);
+          break;
+        }
+      case bind::stream:
+        {
+          assert (false); // Streams cannot be keys.
+          break;
+        }
+      }
+    }
+
+    bool select_statement::
+    key_equal (const cached_value& x,
+               const cached_value& y,
+               bind::buffer_type t)
+    {
+      // Same as in SQL, NULL is not equal to anything.
+      //
+      if (x.null || y.null)
+        return false;
+
+      switch (t)
+      {
+      case bind::integer:
+      case bind::stream:
+        return x.integer == y.integer;
+      case bind::real:
+        return x.real == y.real;
+      case bind::text:
+      case bind::text16:
+      case bind::blob:
+      case bind::text_view:
+      case bind::blob_view:
+        return x.size == y.size &&
+          (x.size == 0 ||
+           memcmp (&data_[x.offset], &data_[y.offset], x.size) == 0);
+      }
+
+      return false;
+    }
+
+    bool select_statement::
+    load_cached (bool truncated)
+    {
+      // Skip the key columns, if any.
+      //
+      return load_row (&values_[(position_ - 1) * columns_ + key_count_],
+                       columns_ - key_count_,
+                       data_,
+                       truncated);
+    }
+
+    bool select_statement::
+    load_row (const cached_value* v,
+              size_t m,
+              const vector<char>& data,
+              bool truncated)
+    {
+      bool r (true);
+
+      size_t n (0);
+      for (size_t i (0); i != result_.count && n != m; ++i)
+      {
+        const bind& b (result_.bind[i]);
+
+        if (b.buffer == 0) // Skip NULL entries.
+          continue;
+
+        const cached_value& cv (v[n++]);
+
+        if (truncated && (b.truncated == 0 || !*b.truncated))
+          continue;
+
+        if (b.truncated != 0)
+          *b.truncated = false;
+
+        if (!truncated)
+        {
+          *b.is_null = cv.null;
+
+          if (cv.null)
+            continue;
+        }
+
+        switch (b.type)
+        {
+        case bind::integer:
+          {
+            *static_cast<long long*> (b.buffer) = cv.integer;
+            break;
+          }
+        case bind::real:
+          {
+            *static_cast<double*> (b.buffer) = cv.real;
+            break;
+          }
+        case bind::text:
+        case bind::text16:
+        case bind::blob:
+          {
+            *b.size = cv.size;
+
+            if (*b.size > b.capacity)
+            {
+              if (b.truncated != 0)
+                *b.truncated = true;
+
+              r = false;
+              continue;
+            }
+
+            if (cv.size != 0)
+              memcpy (*static_cast<void**> (b.buffer),
+                      &data[cv.offset],
+                      cv.size);
+            break;
+          }
+        case bind::text_view:
+        case bind::blob_view:
+          {
+            // Point to the cached data. Use an empty string rather than
+            // NULL for empty values (NULL data pointer means NULL value
+            // when bound as a parameter).
+            //
+            *b.size = cv.size;
+            *static_cast<const void**> (b.buffer) =
+              cv.size != 0 ? &data[cv.offset] : "";
+            break;
+          }
+        case bind::stream:
+          {
+            stream_buffers& sb (*static_cast<stream_buffers*> (b.buffer));
+
+            const char* p (&data[cv.offset]);
+            sb.db.in = p;
+            p += strlen (p) + 1;
+            sb.table.in = p;
+            p += strlen (p) + 1;
+            sb.column.in = p;
+            sb.rowid.in = cv.integer;
+            break;
+          }
+        }
+      }
+
+      return r;
+    }
+
+    bool select_statement::
+    next ()
+    {
+      if (redirect_ != 0)
+      {
+        if (!done_)
+        {
+          done_ = row_;
+          row_ = !row_;
+        }
+
+        return !done_;
+      }
+
+      if (cached_)
+      {
+        if (!done_)
+        {
+          if (position_ != cache_size_)
+            position_++;
+          else
+            done_ = true;
+        }
+
+        return !done_;
+      }
+
+      if (!done_)
+      {
+        int e (SQLITE_LOCKED);
+
+        // Get the next row from the helper thread if prefetching. If it got
+        // SQLITE_LOCKED, then retry the step ourselves since waiting for
+        // the unlock notification is done on this thread.
+        //
+        if (prefetch_)
+          e = next_prefetched ();
+
+        if (e == SQLITE_LOCKED)
+        {
+#ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
+          sqlite3* h (conn_.handle ());
+          while ((e = step ()) == SQLITE_LOCKED)
+          {
+            if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
+              break;
+
+            sqlite3_reset (stmt_);
+            wait ();
+          }
+#else
+          e = step ();
+#endif
+        }
+
+        row_ = e == SQLITE_ROW;
+        loaded_ = false;
+
+        if (row_)
+          rows_++;
+        else
+        {
+          done_ = true;
+          trace_end ();
+
+          // sqlite3_step() will return a detailed error code only if we used
+          // sqlite3_prepare_v2(). Otherwise, sqlite3_reset() returns the
+          // error.
+          //
+#if SQLITE_VERSION_NUMBER >= 3003011
+          reset ();
+
+          if (e != SQLITE_DONE)
+#else
+          e = reset ();
+
+          if (e != SQLITE_OK)
+#endif
+            translate_error (e, conn_);
+        }
+      }
+
+      return !done_;
+    }
+
+    select_statement::result select_statement::
+    load ()
+    {
+      if (done_)
+        return no_data;
+
+      if (cached_)
+        return load_cached (false) ? success : truncated;
+
+      loaded_ = true;
+
+      if (prefetch_)
+      {
+        const prefetch_data::row& r (prefetch_->rows[prefetch_->current]);
+        return load_row (r.values.empty () ? 0 : &r.values[0],
+                         r.values.size (),
+                         r.data,
+                         false) ? success : truncated;
+      }
+
+      if (redirect_ != 0)
+        return redirect_->bind_result (result_.bind,
+                                       result_.count,
+                                       false,
+                                       redirect_column_,
+                                       true) ? success : truncated;
+
+      return bind_result (result_.bind, result_.count, false, 0, wide_)
+        ? success
+        : truncated;
+    }
+
+    void select_statement::
+    pin_views ()
+    {
+      loaded_ = false;
+
+      // Calculate the size of the data for the view columns first since
+      // growing the buffer would invalidate the pointers into it.
+      //
+      size_t n (0);
+      for (size_t i (0); i != result_.count; ++i)
+      {
+        const bind& b (result_.bind[i]);
+
+        if (b.buffer != 0 &&
+            (b.type == bind::text_view || b.type == bind::blob_view) &&
+            !*b.is_null)
+          n += *b.size;
+      }
+
+      if (n == 0)
+        return;
+
+      view_data_.resize (n);
+
+      n = 0;
+      for (size_t i (0); i != result_.count; ++i)
+      {
+        const bind& b (result_.bind[i]);
+
+        if (b.buffer != 0 &&
+            (b.type == bind::text_view || b.type == bind::blob_view) &&
+            !*b.is_null &&
+            *b.size != 0)
+        {
+          const void*& d (*static_cast<const void**> (b.buffer));
+          memcpy (&view_data_[n], d, *b.size);
+          d = &view_data_[n];
+          n += *b.size;
+        }
+      }
+    }
+
+    void select_statement::
+    reload ()
+    {
+      assert (!done_);
+
+      bool r;
+
+      if (cached_)
+        r = load_cached (true);
+      else if (prefetch_)
+      {
+        const prefetch_data::row& pr (prefetch_->rows[prefetch_->current]);
+        r = load_row (pr.values.empty () ? 0 : &pr.values[0],
+                      pr.values.size (),
+                      pr.data,
+                      true);
+      }
+      else if (redirect_ != 0)
+        r = redirect_->bind_result (
+          result_.bind, result_.count, true, redirect_column_, true);
+      else
+        r = bind_result (result_.bind, result_.count, true, 0, wide_);
+
+      if (!r)
+        assert (false);
+    }
+
+    void select_statement::
+    clear ()
+    {
+      if (prefetch_)
+        stop_prefetch ();
+
+      trace_end ();
+      statement::clear ();
+    }
+
+    void select_statement::
+    prefetch (size_t n)
+    {
+#if !defined(ODB_THREADS_NONE) && SQLITE_VERSION_NUMBER >= 3006000
+      if (n == 0 || prefetch_ || cached_ || done_ || row_ || key_count_ != 0)
+        return;
+
+      // Without the connection mutex it is not safe to use the connection
+      // from several threads.
+      //
+      if (sqlite3_db_mutex (conn_.handle ()) == 0)
+        return;
+
+      // One more row for the one being loaded by the caller.
+      //
+      prefetch_.reset (new prefetch_data (n + 1, result_));
+
+      try
+      {
+        prefetch_->thread.reset (
+          new details::thread (&prefetch_thread, this));
+      }
+      catch (...)
+      {
+        prefetch_.reset ();
+        throw;
+      }
+#else
+      ODB_POTENTIALLY_UNUSED (n);
+#endif
+    }
+
+    void* select_statement::
+    prefetch_thread (void* arg)
+    {
+      static_cast<select_statement*> (arg)->prefetch_run ();
+      return 0;
+    }
+
+    void select_statement::
+    prefetch_run ()
+    {
+      using details::lock;
+
+      prefetch_data& p (*prefetch_);
+      size_t n (p.rows.size ());
+      int e (SQLITE_OK);
+
+      for (;;)
+      {
+        size_t i;
+        {
+          lock l (p.mutex);
+
+          p.producer_waiting = true;
+          while (!p.stop && p.count + (p.busy ? 1 : 0) == n)
+            p.space.wait (l);
+          p.producer_waiting = false;
+
+          if (p.stop)
+          {
+            e = SQLITE_OK;
+            break;
+          }
+
+          i = (p.head + p.count) % n;
+        }
+
+        // Errors (as well as SQLITE_LOCKED) are handled by the caller's
+        // thread once it gets to this point.
+        //
+        if ((e = step ()) != SQLITE_ROW)
+          break;
+
+        prefetch_data::row& r (p.rows[i]);
+        r.values.clear ();
+        r.data.clear ();
+
+        try
+        {
+          cache_row (&p.binds[0], p.binds.size (), r.values, r.data);
+        }
+        catch (const std::bad_alloc&)
+        {
+          e = SQLITE_NOMEM;
+          break;
+        }
+
+        lock l (p.mutex);
+        p.count++;
+
+        if (p.consumer_waiting)
+          p.ready.signal ();
+      }
+
+      lock l (p.mutex);
+      p.code = e;
+      p.finished = true;
+      p.ready.signal ();
+    }
+
+    int select_statement::
+    next_prefetched ()
+    {
+      using details::lock;
+
+      prefetch_data& p (*prefetch_);
+      {
+        lock l (p.mutex);
+
+        if (p.busy)
+        {
+          p.busy = false;
+
+          if (p.producer_waiting)
+            p.space.signal ();
+        }
+
+        p.consumer_waiting = true;
+        while (p.count == 0 && !p.finished)
+          p.ready.wait (l);
+        p.consumer_waiting = false;
+
+        if (p.count != 0)
+        {
+          p.current = p.head;
+          p.head = (p.head + 1) % p.rows.size ();
+          p.count--;
+          p.busy = true;
+          return SQLITE_ROW;
+        }
+      }
+
+      int e (p.code);
+      stop_prefetch ();
+      return e;
+    }
+
+    size_t select_statement::
+    cache_prefetched ()
+    {
+      prefetch_data& p (*prefetch_);
+
+      {
+        details::lock l (p.mutex);
+        p.stop = true;
+        p.space.signal ();
+      }
+
+#ifndef ODB_THREADS_NONE
+      p.thread->join ();
+#endif
+
+      // The current row followed by the ones not yet seen by the caller.
+      //
+      size_t n (0);
+      for (size_t i (row_ && p.busy ? 0 : 1); i <= p.count; ++i, ++n)
+      {
+        const prefetch_data::row& r (
+          p.rows[i == 0 ? p.current : (p.head + i - 1) % p.rows.size ()]);
+
+        size_t o (data_.size ());
+        data_.insert (data_.end (), r.data.begin (), r.data.end ());
+
+        for (vector<cached_value>::const_iterator j (r.values.begin ());
+             j != r.values.end ();
+             ++j)
+        {
+          values_.push_back (*j);
+          values_.back ().offset += o;
+        }
+
+        columns_ = r.values.size ();
+      }
+
+      rows_ += p.count;
+
+      bool f (p.finished);
+      int e (p.code);
+      prefetch_.reset ();
+
+      // If the helper thread has reached the end of the result set (or
+      // failed), then handle it the same way as next() would.
+      //
+      if (f && e != SQLITE_OK && e != SQLITE_LOCKED)
+      {
+        done_ = true;
+        trace_end ();
+        reset ();
+
+        if (e != SQLITE_DONE)
+          translate_error (e, conn_);
+      }
+
+      return n;
+    }
+
+    void select_statement::
+    stop_prefetch ()
+    {
+      prefetch_data& p (*prefetch_);
+
+      {
+        details::lock l (p.mutex);
+        p.stop = true;
+        p.space.signal ();
+      }
+
+#ifndef ODB_THREADS_NONE
+      p.thread->join ();
+#endif
+
+      prefetch_.reset ();
+    }
+
+    // insert_statement
+    //
+
+    insert_statement::
+    insert_statement (connection_type& conn,
+                      const string& text,
+                      bool process,
+                      binding& param,
+                      binding* returning)
+        : statement (conn,
+                     text, statement_insert,
+                     (process ? &param : 0), false),
+          param_ (param),
+          returning_ (returning),
+          mex_ (0)
+    {
+    }
+
+    insert_statement::
+    insert_statement (connection_type& conn,
+                      const char* text,
+                      bool process,
+                      binding& param,
+                      binding* returning)
+        : statement (conn,
+                     text, statement_insert,
+                     (process ? &param : 0), false),
+          param_ (param),
+          returning_ (returning),
+          mex_ (0)
+    {
+    }
+
+    bool insert_statement::
+    execute ()
+    {
+      {
+        odb::tracer* t;
+        if ((t = conn_.main_connection ().transaction_tracer ()) ||
+            (t = conn_.tracer ()) ||
+            (t = conn_.database ().tracer ()))
+          t->execute (conn_, *this);
+
+        trace_start (t);
+      }
+
+      int e (execute (0));
+
+      if (trace_ != 0)
+      {
+        trace_stats_.rows_affected = (e == SQLITE_DONE ? 1 : 0);
+        trace_end ();
+      }
+
+      if (e != SQLITE_DONE)
+      {
+        // SQLITE_CONSTRAINT error code covers more than just a duplicate
+        // primary key. Unfortunately, there is nothing more precise that
+        // we can use (even sqlite3_errmsg() returns generic "constraint
+        // failed"). But an auto-assigned object id should never cause a
+        // duplicate primary key.
+        //
+        if (returning_ == 0 && e == SQLITE_CONSTRAINT)
+          return false;
+        else
+          translate_error (e, conn_);
+      }
+
+      return true;
+    }
+
+    size_t insert_statement::
+    execute (size_t n, multiple_exceptions& mex)
+    {
+      assert (n <= param_.batch);
+
+      {
+        odb::tracer* t;
+        if ((t = conn_.main_connection ().transaction_tracer ()) ||
+            (t = conn_.tracer ()) ||
+            (t = conn_.database ().tracer ()))
+          t->execute (conn_, *this);
+
+        trace_start (t);
+      }
+
+      mex_ = &mex;
+
+      size_t i (0);
+      for (bool fatal (false); i != n && !fatal; ++i)
+      {
+        int e (execute (i));
+        param_.status[i] = (e == SQLITE_DONE ? 1 : 0);
+        trace_stats_.rows_affected += param_.status[i];
+
+        // See execute() above for details on the duplicate detection.
+        //
+        if (e != SQLITE_DONE && (returning_ != 0 || e != SQLITE_CONSTRAINT))
+          fatal = batch_error (e, i, mex);
+      }
+
+      mex.attempted (i);
+      trace_end ();
+      return i;
+    }
+
+    int insert_statement::
+    execute (size_t i)
+    {
+      sqlite3* h (conn_.handle ());
+      size_t o (i * param_.skip);
+      bool stream (bind_param (param_.bind, param_.count, o));
+
+      stream_data sd;
+      if (stream)
+        sqlite3_update_hook (h, &odb_sqlite_update_hook, &sd);
+
+      int e;
+
+#ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
+      while ((e = step ()) == SQLITE_LOCKED)
+      {
+        if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
+          break;
+
+        sqlite3_reset (stmt_);
+        wait ();
       }
+#else
+      e = step ();
+#endif
+
+      if (stream)
+        sqlite3_update_hook (h, 0, 0); // Clear the hook.
+
+      // sqlite3_step() will return a detailed error code only if we used
+      // sqlite3_prepare_v2(). Otherwise, sqlite3_reset() returns the
+      // error.
+      //
+#if SQLITE_VERSION_NUMBER >= 3003011
+      sqlite3_reset (stmt_);
+
+      if (e != SQLITE_DONE)
+        return e;
+#else
+      e = sqlite3_reset (stmt_);
+
+      if (e != SQLITE_OK)
+        return e;
+#endif
 
       // Stream parameters, if any.
       //
       if (stream)
-        stream_param (param_.bind, param_.count, sd);
+        stream_param (param_.bind, param_.count, sd, o);
 
       if (returning_ != 0)
       {
         bind& b (returning_->bind[0]);
+        size_t ro (i * returning_->skip);
 
-        *b.is_null = false;
-        *static_cast<long long*> (b.buffer) =
+        *offset (b.is_null, ro) = false;
+        *offset (static_cast<long long*> (b.buffer), ro) =
           static_cast<long long> (
             sqlite3_last_insert_rowid (h));
       }
 
-      return true;
+      return SQLITE_DONE;
     }
 
     // update_statement
@@ -836,7 +1960,8 @@ namespace odb
         : statement (conn,
                      text, statement_update,
                      (process ? &param : 0), false),
-          param_ (param)
+          param_ (param),
+          mex_ (0)
     {
     }
 
@@ -848,7 +1973,8 @@ namespace odb
         : statement (conn,
                      text, statement_update,
                      (process ? &param : 0), false),
-          param_ (param)
+          param_ (param),
+          mex_ (0)
     {
     }
 
@@ -861,10 +1987,76 @@ namespace odb
             (t = conn_.tracer ()) ||
             (t = conn_.database ().tracer ()))
           t->execute (conn_, *this);
+
+        trace_start (t);
+      }
+
+      int e (execute (0));
+
+      if (trace_ != 0)
+      {
+        if (e == SQLITE_DONE)
+          trace_stats_.rows_affected = static_cast<unsigned long long> (
+            sqlite3_changes (conn_.handle ()));
+
+        trace_end ();
+      }
+
+      if (e != SQLITE_DONE)
+        translate_error (e, conn_);
+
+      return static_cast<unsigned long long> (
+        sqlite3_changes (conn_.handle ()));
+    }
+
+    size_t update_statement::
+    execute (size_t n, multiple_exceptions& mex)
+    {
+      assert (n <= param_.batch);
+
+      {
+        odb::tracer* t;
+        if ((t = conn_.main_connection ().transaction_tracer ()) ||
+            (t = conn_.tracer ()) ||
+            (t = conn_.database ().tracer ()))
+          t->execute (conn_, *this);
+
+        trace_start (t);
+      }
+
+      mex_ = &mex;
+
+      sqlite3* h (conn_.handle ());
+
+      size_t i (0);
+      for (bool fatal (false); i != n && !fatal; ++i)
+      {
+        int e (execute (i));
+
+        if (e == SQLITE_DONE)
+        {
+          param_.status[i] = static_cast<unsigned long long> (
+            sqlite3_changes (h));
+          trace_stats_.rows_affected += param_.status[i];
+        }
+        else
+        {
+          param_.status[i] = result_unknown;
+          fatal = batch_error (e, i, mex);
+        }
       }
 
+      mex.attempted (i);
+      trace_end ();
+      return i;
+    }
+
+    int update_statement::
+    execute (size_t i)
+    {
       sqlite3* h (conn_.handle ());
-      bool stream (bind_param (param_.bind, param_.count));
+      size_t o (i * param_.skip);
+      bool stream (bind_param (param_.bind, param_.count, o));
 
       stream_data sd;
       if (stream)
@@ -873,16 +2065,16 @@ namespace odb
       int e;
 
 #ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
-      while ((e = sqlite3_step (stmt_)) == SQLITE_LOCKED)
+      while ((e = step ()) == SQLITE_LOCKED)
       {
         if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
           break;
 
         sqlite3_reset (stmt_);
-        conn_.wait ();
+        wait ();
       }
 #else
-      e = sqlite3_step (stmt_);
+      e = step ();
 #endif
 
       if (stream)
@@ -896,21 +2088,20 @@ namespace odb
       sqlite3_reset (stmt_);
 
       if (e != SQLITE_DONE)
+        return e;
 #else
       e = sqlite3_reset (stmt_);
 
       if (e != SQLITE_OK)
+        return e;
 #endif
-        translate_error (e, conn_);
-
-      int r (sqlite3_changes (h));
 
       // Stream parameters, if any.
       //
-      if (stream && r != 0)
-        stream_param (param_.bind, param_.count, sd);
+      if (stream && sqlite3_changes (h) != 0)
+        stream_param (param_.bind, param_.count, sd, o);
 
-      return static_cast<unsigned long long> (r);
+      return SQLITE_DONE;
     }
 
     // delete_statement
@@ -923,7 +2114,8 @@ namespace odb
         : statement (conn,
                      text, statement_delete,
                      0, false),
-          param_ (param)
+          param_ (param),
+          mex_ (0)
     {
     }
 
@@ -934,7 +2126,8 @@ namespace odb
         : statement (conn,
                      text, statement_delete,
                      0, false),
-          param_ (param)
+          param_ (param),
+          mex_ (0)
     {
     }
 
@@ -947,24 +2140,89 @@ namespace odb
             (t = conn_.tracer ()) ||
             (t = conn_.database ().tracer ()))
           t->execute (conn_, *this);
+
+        trace_start (t);
       }
 
-      bind_param (param_.bind, param_.count);
+      int e (execute (0));
+
+      if (trace_ != 0)
+      {
+        if (e == SQLITE_DONE)
+          trace_stats_.rows_affected = static_cast<unsigned long long> (
+            sqlite3_changes (conn_.handle ()));
+
+        trace_end ();
+      }
+
+      if (e != SQLITE_DONE)
+        translate_error (e, conn_);
+
+      return static_cast<unsigned long long> (
+        sqlite3_changes (conn_.handle ()));
+    }
+
+    size_t delete_statement::
+    execute (size_t n, multiple_exceptions& mex)
+    {
+      assert (n <= param_.batch);
+
+      {
+        odb::tracer* t;
+        if ((t = conn_.main_connection ().transaction_tracer ()) ||
+            (t = conn_.tracer ()) ||
+            (t = conn_.database ().tracer ()))
+          t->execute (conn_, *this);
+
+        trace_start (t);
+      }
+
+      mex_ = &mex;
 
-      int e;
       sqlite3* h (conn_.handle ());
 
+      size_t i (0);
+      for (bool fatal (false); i != n && !fatal; ++i)
+      {
+        int e (execute (i));
+
+        if (e == SQLITE_DONE)
+        {
+          param_.status[i] = static_cast<unsigned long long> (
+            sqlite3_changes (h));
+          trace_stats_.rows_affected += param_.status[i];
+        }
+        else
+        {
+          param_.status[i] = result_unknown;
+          fatal = batch_error (e, i, mex);
+        }
+      }
+
+      mex.attempted (i);
+      trace_end ();
+      return i;
+    }
+
+    int delete_statement::
+    execute (size_t i)
+    {
+      bind_param (param_.bind, param_.count, i * param_.skip);
+
+      int e;
+
 #ifdef LIBODB_SQLITE_HAVE_UNLOCK_NOTIFY
-      while ((e = sqlite3_step (stmt_)) == SQLITE_LOCKED)
+      sqlite3* h (conn_.handle ());
+      while ((e = step ()) == SQLITE_LOCKED)
       {
         if (sqlite3_extended_errcode (h) != SQLITE_LOCKED_SHAREDCACHE)
           break;
 
         sqlite3_reset (stmt_);
-        conn_.wait ();
+        wait ();
       }
 #else
-      e = sqlite3_step (stmt_);
+      e = step ();
 #endif
 
       // sqlite3_step() will return a detailed error code only if we used
@@ -975,14 +2233,15 @@ namespace odb
       sqlite3_reset (stmt_);
 
       if (e != SQLITE_DONE)
+        return e;
 #else
       e = sqlite3_reset (stmt_);
 
       if (e != SQLITE_OK)
+        return e;
 #endif
-        translate_error (e, conn_);
 
-      return static_cast<unsigned long long> (sqlite3_changes (h));
+      return SQLITE_DONE;
     }
   }
 }
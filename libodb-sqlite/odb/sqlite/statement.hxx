@@ -9,11 +9,16 @@
 #include <sqlite3.h>
 
 #include <string>
+#include <vector>
 #include <cstddef> // std::size_t
 #include <cstring> // std::strlen, std::memcpy
 #include <cassert>
 
+#include <odb/tracer.hxx>
 #include <odb/statement.hxx>
+#include <odb/exceptions.hxx> // multiple_exceptions
+
+#include <odb/details/unique-ptr.hxx>
 
 #include <odb/sqlite/version.hxx>
 #include <odb/sqlite/forward.hxx>
@@ -99,18 +104,31 @@ namespace odb
       }
 
     protected:
-      // Return true if we bound any stream parameters.
+      // Return true if we bound any stream parameters. The offset argument
+      // is added to the buffer, size, and is_null pointers and is used to
+      // bind an image other than the first one in bulk operations. The
+      // first argument is the (1-based) index of the first parameter.
       //
       bool
-      bind_param (const bind*, std::size_t count);
+      bind_param (const bind*,
+                  std::size_t count,
+                  std::size_t offset = 0,
+                  std::size_t first = 1);
 
       // Extract row columns into the bound buffers. If the truncated
       // argument is true, then only truncated columns are extracted.
       // Return true if all the data was extracted successfully and
-      // false if one or more columns were truncated.
+      // false if one or more columns were truncated. The first argument
+      // is the (0-based) index of the first column to extract and, unless
+      // the partial argument is true, the row should have no columns
+      // after those extracted.
       //
       bool
-      bind_result (const bind*, std::size_t count, bool truncated = false);
+      bind_result (const bind*,
+                   std::size_t count,
+                   bool truncated = false,
+                   std::size_t first = 0,
+                   bool partial = false);
 
       // Stream (so to speak) parameters.
       //
@@ -122,7 +140,15 @@ namespace odb
       };
 
       void
-      stream_param (const bind*, std::size_t count, const stream_data&);
+      stream_param (const bind*, std::size_t count, const stream_data&,
+                    std::size_t offset = 0);
+
+      // Record the error returned by sqlite3_step() for the specified batch
+      // position. Return true if the error is fatal, that is, it caused
+      // SQLite to roll back the transaction.
+      //
+      bool
+      batch_error (int e, std::size_t position, multiple_exceptions&);
 
       friend void
       update_hook (void*, const char*, const char*, long long);
@@ -168,6 +194,37 @@ namespace odb
       virtual void
       clear ();
 
+      // Execution statistics (see odb::tracer::executed()). The tracer, if
+      // any, is saved when the execution starts and the statistics are
+      // reported to it by trace_end().
+      //
+    protected:
+      void
+      trace_start (odb::tracer* t)
+      {
+        trace_ = t;
+
+        if (t != 0)
+          trace_stats_ = odb::tracer::execution_stats ();
+      }
+
+      void
+      trace_end ();
+
+      // Call sqlite3_step() timing it if tracing.
+      //
+      int
+      step ();
+
+      // Wait for the unlock notification (see connection::wait()).
+      //
+      void
+      wait ()
+      {
+        conn_.wait ();
+        trace_stats_.lock_waits++;
+      }
+
     protected:
       auto_handle<sqlite3_stmt> stmt_;
 
@@ -177,6 +234,9 @@ namespace odb
 
       bool active_;
 
+      odb::tracer* trace_;
+      odb::tracer::execution_stats trace_stats_;
+
     private:
       void
       init (const char* text,
@@ -209,6 +269,9 @@ namespace odb
     class LIBODB_SQLITE_EXPORT select_statement: public statement
     {
     public:
+      virtual
+      ~select_statement ();
+
       select_statement (connection_type& conn,
                         const std::string& text,
                         bool process_text,
@@ -286,14 +349,263 @@ namespace odb
       void
       reload ();
 
+      // Change the parameter binding. Used to re-execute a cached
+      // statement with the parameters of another query.
+      //
+      void
+      param (binding& p)
+      {
+        param_ = &p;
+      }
+
+      // Fetch the remaining rows (including the current one, if any) into
+      // memory and reset the statement so that other statements can be
+      // executed on the connection. After this call next(), load(), and
+      // reload() work on the cached rows.
+      //
+      void
+      cache ();
+
+      bool
+      cached () const
+      {
+        return cached_;
+      }
+
+      // Number of rows in the result set. Only known once the result
+      // is cached.
+      //
+      std::size_t
+      row_count () const
+      {
+        return rows_;
+      }
+
+      // Cached result set positioning. The position is 1-based with 0
+      // meaning before the first row. Note that the new position should
+      // refer to an existing row.
+      //
+      std::size_t
+      position () const
+      {
+        return position_;
+      }
+
+      void
+      position (std::size_t p)
+      {
+        position_ = p;
+      }
+
+      std::size_t
+      cache_size () const
+      {
+        return cache_size_;
+      }
+
+      // Keyed mode. In this mode the statement is executed for the images
+      // in param.prefetch, if any (see binding), and each row starts
+      // with n key columns that identify the image it belongs to (the
+      // rows should be ordered by these columns). The statement is used
+      // to fetch rows for several parameter images (for example, container
+      // elements of several objects) at once: after execute() and cache(),
+      // call select_key() to restrict next() to the rows that belong to
+      // the parameter values in the first image.
+      //
+      void
+      key (std::size_t n)
+      {
+        key_count_ = n;
+      }
+
+      // Return false if the statement was not executed for the parameter
+      // values currently in the first image.
+      //
+      bool
+      select_key ();
+
+      // Prefetch mode. In this mode the rows are fetched and copied into
+      // a ring buffer of the specified number of rows by a helper thread
+      // while the caller processes earlier rows with next() and load().
+      // Should be called after execute() but before the first next().
+      //
+      // Because the helper thread steps the statement while the caller
+      // may execute other statements on the same connection, this mode
+      // requires the connection to be opened in the serialized threading
+      // mode (SQLITE_OPEN_FULLMUTEX). If that's not the case (or if the
+      // statement is in the keyed mode or there is no thread support),
+      // then this call is ignored and the rows are fetched as usual.
+      //
+      void
+      prefetch (std::size_t rows);
+
+      bool
+      prefetching () const
+      {
+        return prefetch_.get () != 0;
+      }
+
+      // Wide mode. In this mode the result set contains extra columns
+      // after those in the result binding (for example, the columns of
+      // the derived classes in a polymorphic object query). They are
+      // ignored by load() and cache() but can be loaded into another
+      // statement's binding with redirect().
+      //
+      void
+      wide (bool w)
+      {
+        wide_ = w;
+      }
+
+      bool
+      wide () const
+      {
+        return wide_;
+      }
+
+      // Redirect mode. In this mode the statement is not executed and
+      // instead has a single row that is made up of the columns of the
+      // source statement's current row starting with the specified
+      // (0-based) column. The source statement should be in the wide
+      // mode and not cached or prefetching. The redirect mode ends with
+      // the call to free_result().
+      //
+      void
+      redirect (select_statement& source, std::size_t column)
+      {
+        redirect_ = &source;
+        redirect_column_ = column;
+      }
+
+      // The active_object interface.
+      //
+      virtual void
+      clear ();
+
     private:
       select_statement (const select_statement&);
       select_statement& operator= (const select_statement&);
 
+      // Report the execution statistics, if tracing.
+      //
+      void
+      trace_end ()
+      {
+        if (trace_ != 0)
+        {
+          trace_stats_.rows_fetched = rows_;
+          statement::trace_end ();
+        }
+      }
+
+      struct cached_value;
+
+      // Copy the current row into the values and data vectors returning
+      // the number of values.
+      //
+      std::size_t
+      cache_row (const bind*, std::size_t count,
+                 std::vector<cached_value>&, std::vector<char>&);
+
+      void
+      cache_row ();
+
+      void
+      cache_value (const bind&, int column,
+                   cached_value&, std::vector<char>&);
+
+      void
+      param_value (const bind&, std::size_t offset, cached_value&);
+
+      bool
+      key_equal (const cached_value&, const cached_value&, bind::buffer_type);
+
+      // Copy the data of the text_view and blob_view columns of the loaded
+      // row into view_data_ and repoint the images to it.
+      //
+      void
+      pin_views ();
+
+      bool
+      load_cached (bool truncated);
+
+      bool
+      load_row (const cached_value*, std::size_t count,
+                const std::vector<char>& data,
+                bool truncated);
+
+      struct prefetch_data;
+
+      static void*
+      prefetch_thread (void*);
+
+      void
+      prefetch_run ();
+
+      // Move to the next prefetched row returning SQLITE_ROW. If there are
+      // no more rows, stop prefetching and return the final sqlite3_step()
+      // result.
+      //
+      int
+      next_prefetched ();
+
+      // Stop prefetching and move the current and the remaining prefetched
+      // rows to the cache.
+      //
+      std::size_t
+      cache_prefetched ();
+
+      void
+      stop_prefetch ();
+
     private:
       bool done_;
+      bool row_; // True if positioned on a row.
       binding* param_;
       binding& result_;
+
+      // True if the current row was loaded directly from SQLite. In this
+      // case the text_view and blob_view images point to the SQLite
+      // memory which is only valid until the statement is stepped or
+      // reset. To allow loading a single row and then freeing the result
+      // (the find() case), we copy this data on free_result().
+      //
+      bool loaded_;
+      std::vector<char> view_data_;
+
+      // Cached result set. Each row is stored as columns_ values with
+      // text, blob, and stream column names data kept in data_.
+      //
+      struct cached_value
+      {
+        bool null;
+        long long integer; // Integer value or stream ROWID.
+        double real;
+        std::size_t offset;
+        std::size_t size;
+      };
+
+      bool cached_;
+      std::size_t rows_;
+      std::size_t columns_;
+      std::size_t cache_size_;
+      std::size_t position_; // Current cached row, 1-based.
+      std::vector<cached_value> values_;
+      std::vector<char> data_;
+
+      // Keyed mode. The keys_ vector contains the parameter values the
+      // statement was executed with and groups_ -- the first row of each
+      // distinct key value plus the end position.
+      //
+      std::size_t key_count_;
+      std::vector<cached_value> keys_;
+      std::vector<std::size_t> groups_;
+
+      details::unique_ptr<prefetch_data> prefetch_;
+
+      bool wide_;
+      select_statement* redirect_;
+      std::size_t redirect_column_;
     };
 
     struct auto_result
@@ -330,13 +642,39 @@ namespace odb
       bool
       execute ();
 
+      // Return the number of parameter sets (out of n) that were attempted.
+      // SQLite has no notion of array parameters so the batch is executed
+      // by re-binding and stepping the same prepared statement for each
+      // parameter set. Errors other than duplicates are recorded in mex.
+      //
+      std::size_t
+      execute (std::size_t n, multiple_exceptions& mex);
+
+      // Return true if successful and false if this row is a duplicate.
+      // Also set the current position in mex.
+      //
+      bool
+      result (std::size_t i)
+      {
+        mex_->current (i);
+        return param_.status[i] != 0;
+      }
+
     private:
       insert_statement (const insert_statement&);
       insert_statement& operator= (const insert_statement&);
 
+      // Bind the parameter set at the specified batch position and step
+      // the statement. Return SQLITE_DONE on success and the error code
+      // otherwise.
+      //
+      int
+      execute (std::size_t i);
+
     private:
       binding& param_;
       binding* returning_;
+      multiple_exceptions* mex_;
     };
 
     class LIBODB_SQLITE_EXPORT update_statement: public statement
@@ -355,12 +693,37 @@ namespace odb
       unsigned long long
       execute ();
 
+      // Return the number of parameter sets (out of n) that were attempted.
+      // See insert_statement::execute() for details.
+      //
+      std::size_t
+      execute (std::size_t n, multiple_exceptions& mex);
+
+      // Return the number of rows affected (updated) by the parameter
+      // set. If this parameter set failed, then return result_unknown.
+      // Also set the current position in mex.
+      //
+      static const unsigned long long result_unknown = ~0ULL;
+
+      unsigned long long
+      result (std::size_t i)
+      {
+        mex_->current (i);
+        return param_.status[i];
+      }
+
     private:
       update_statement (const update_statement&);
       update_statement& operator= (const update_statement&);
 
+      // Return SQLITE_DONE on success and the error code otherwise.
+      //
+      int
+      execute (std::size_t i);
+
     private:
       binding& param_;
+      multiple_exceptions* mex_;
     };
 
     class LIBODB_SQLITE_EXPORT delete_statement: public statement
@@ -377,12 +740,37 @@ namespace odb
       unsigned long long
       execute ();
 
+      // Return the number of parameter sets (out of n) that were attempted.
+      // See insert_statement::execute() for details.
+      //
+      std::size_t
+      execute (std::size_t n, multiple_exceptions& mex);
+
+      // Return the number of rows affected (deleted) by the parameter
+      // set. If this parameter set failed, then return result_unknown.
+      // Also set the current position in mex.
+      //
+      static const unsigned long long result_unknown = ~0ULL;
+
+      unsigned long long
+      result (std::size_t i)
+      {
+        mex_->current (i);
+        return param_.status[i];
+      }
+
     private:
       delete_statement (const delete_statement&);
       delete_statement& operator= (const delete_statement&);
 
+      // Return SQLITE_DONE on success and the error code otherwise.
+      //
+      int
+      execute (std::size_t i);
+
     private:
       binding& param_;
+      multiple_exceptions* mex_;
     };
   }
 }
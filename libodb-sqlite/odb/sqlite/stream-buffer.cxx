@@ -0,0 +1,269 @@
+// file      : odb/sqlite/stream-buffer.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <sqlite3.h>
+
+#if SQLITE_VERSION_NUMBER >= 3004000
+
+#include <odb/sqlite/stream-buffer.hxx>
+
+#include <cstring> // std::memcpy
+
+using namespace std;
+
+namespace odb
+{
+  namespace sqlite
+  {
+    stream_buffer::
+    stream_buffer (stream& s, size_t chunk_size)
+        : s_ (s),
+          chunk_ (chunk_size != 0 ? chunk_size : 1),
+          buf_ (chunk_),
+          offset_ (0)
+    {
+      setg (0, 0, 0);
+      setp (0, 0);
+    }
+
+    stream_buffer::
+    ~stream_buffer ()
+    {
+      try
+      {
+        flush ();
+      }
+      catch (...)
+      {
+      }
+    }
+
+#if SQLITE_VERSION_NUMBER >= 3007004
+    void stream_buffer::
+    reopen (long long rowid)
+    {
+      flush ();
+
+      s_.reopen (rowid);
+      offset_ = 0;
+    }
+#endif
+
+    void stream_buffer::
+    flush ()
+    {
+      if (pbase () != 0)
+      {
+        size_t n (static_cast<size_t> (pptr () - pbase ()));
+        setp (0, 0);
+
+        if (n != 0)
+        {
+          s_.write (buf_.data (), n, offset_);
+          offset_ += n;
+        }
+      }
+      else if (eback () != 0)
+      {
+        offset_ += static_cast<size_t> (gptr () - eback ());
+        setg (0, 0, 0);
+      }
+    }
+
+    size_t stream_buffer::
+    position () const
+    {
+      if (eback () != 0)
+        return offset_ + static_cast<size_t> (gptr () - eback ());
+
+      if (pbase () != 0)
+        return offset_ + static_cast<size_t> (pptr () - pbase ());
+
+      return offset_;
+    }
+
+    stream_buffer::int_type stream_buffer::
+    underflow ()
+    {
+      flush ();
+
+      size_t n (s_.size ());
+
+      if (offset_ >= n)
+        return traits_type::eof ();
+
+      n -= offset_;
+      if (n > chunk_)
+        n = chunk_;
+
+      char* b (buf_.data ());
+      s_.read (b, n, offset_);
+      setg (b, b, b + n);
+
+      return traits_type::to_int_type (*b);
+    }
+
+    stream_buffer::int_type stream_buffer::
+    overflow (int_type c)
+    {
+      flush ();
+
+      size_t n (s_.size ());
+
+      // The size of the value cannot be changed with incremental I/O.
+      //
+      if (offset_ >= n)
+        return traits_type::eof ();
+
+      n -= offset_;
+      if (n > chunk_)
+        n = chunk_;
+
+      char* b (buf_.data ());
+      setp (b, b + n);
+
+      if (!traits_type::eq_int_type (c, traits_type::eof ()))
+      {
+        *b = traits_type::to_char_type (c);
+        pbump (1);
+      }
+
+      return traits_type::not_eof (c);
+    }
+
+    int stream_buffer::
+    sync ()
+    {
+      // Also discard the read-ahead data so that we don't return stale
+      // data if the value is modified via another stream.
+      //
+      flush ();
+      return 0;
+    }
+
+    streamsize stream_buffer::
+    showmanyc ()
+    {
+      size_t p (position ()), n (s_.size ());
+      return p < n ? static_cast<streamsize> (n - p) : -1;
+    }
+
+    streamsize stream_buffer::
+    xsgetn (char_type* s, streamsize n)
+    {
+      streamsize r (0);
+
+      // First take what is left in the get area.
+      //
+      if (gptr () != egptr ())
+      {
+        r = egptr () - gptr ();
+
+        if (r > n)
+          r = n;
+
+        memcpy (s, gptr (), static_cast<size_t> (r));
+        gbump (static_cast<int> (r));
+      }
+
+      if (r == n)
+        return r;
+
+      // Transfer large requests directly bypassing the buffer.
+      //
+      if (static_cast<size_t> (n - r) >= chunk_)
+      {
+        sync ();
+
+        size_t z (s_.size ());
+
+        if (offset_ < z)
+        {
+          size_t m (z - offset_);
+
+          if (m > static_cast<size_t> (n - r))
+            m = static_cast<size_t> (n - r);
+
+          s_.read (s + r, m, offset_);
+          offset_ += m;
+          r += static_cast<streamsize> (m);
+        }
+
+        return r;
+      }
+
+      return r + streambuf::xsgetn (s + r, n - r);
+    }
+
+    streamsize stream_buffer::
+    xsputn (const char_type* s, streamsize n)
+    {
+      if (static_cast<size_t> (n) < chunk_)
+        return streambuf::xsputn (s, n);
+
+      sync ();
+
+      size_t z (s_.size ());
+
+      if (offset_ >= z)
+        return 0;
+
+      size_t m (z - offset_);
+
+      if (m > static_cast<size_t> (n))
+        m = static_cast<size_t> (n);
+
+      s_.write (s, m, offset_);
+      offset_ += m;
+
+      return static_cast<streamsize> (m);
+    }
+
+    stream_buffer::pos_type stream_buffer::
+    seekoff (off_type o, ios_base::seekdir d, ios_base::openmode)
+    {
+      off_type p;
+
+      switch (d)
+      {
+      case ios_base::beg:
+        p = o;
+        break;
+      case ios_base::cur:
+        p = static_cast<off_type> (position ()) + o;
+        break;
+      default:
+        p = static_cast<off_type> (s_.size ()) + o;
+        break;
+      }
+
+      if (p < 0 || p > static_cast<off_type> (s_.size ()))
+        return pos_type (off_type (-1));
+
+      // If the new position is within the get area, then just move there.
+      //
+      if (eback () != 0 &&
+          p >= static_cast<off_type> (offset_) &&
+          p <= static_cast<off_type> (offset_) + (egptr () - eback ()))
+      {
+        setg (eback (),
+              eback () + (p - static_cast<off_type> (offset_)),
+              egptr ());
+        return pos_type (p);
+      }
+
+      flush ();
+      offset_ = static_cast<size_t> (p);
+
+      return pos_type (p);
+    }
+
+    stream_buffer::pos_type stream_buffer::
+    seekpos (pos_type p, ios_base::openmode m)
+    {
+      return seekoff (off_type (p), ios_base::beg, m);
+    }
+  }
+}
+
+#endif // SQLITE_VERSION_NUMBER >= 3004000
@@ -0,0 +1,119 @@
+// file      : odb/sqlite/stream-buffer.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SQLITE_STREAM_BUFFER_HXX
+#define ODB_SQLITE_STREAM_BUFFER_HXX
+
+#include <odb/pre.hxx>
+
+#include <sqlite3.h>
+
+#include <cstddef>   // std::size_t
+#include <streambuf>
+
+#include <odb/details/buffer.hxx>
+
+#include <odb/sqlite/stream.hxx>
+#include <odb/sqlite/details/export.hxx>
+
+namespace odb
+{
+  namespace sqlite
+  {
+    // Buffered std::streambuf adapter for the incremental BLOB/TEXT I/O
+    // stream which allows using it with std::istream and std::ostream.
+    //
+    // The data is transferred in chunks of the specified size with
+    // requests for more than a chunk going directly to the stream. The
+    // same buffer is used for reading and writing with the pending
+    // writes flushed before reading, seeking, and on sync(). Note that
+    // incremental I/O cannot change the size of the value and writing
+    // past its end fails. The stream must remain open while the buffer
+    // is in use.
+    //
+    class LIBODB_SQLITE_EXPORT stream_buffer: public std::streambuf
+    {
+    public:
+      explicit
+      stream_buffer (stream&, std::size_t chunk_size = 65536);
+
+      // Flush pending writes, if any, ignoring errors. Call sync() (for
+      // example, via std::ostream::flush()) before destroying the buffer
+      // to detect them.
+      //
+      virtual
+      ~stream_buffer ();
+
+      std::size_t
+      size () const {return s_.size ();}
+
+      stream&
+      underlying () const {return s_;}
+
+      // Flush pending writes, switch the underlying stream to the same
+      // BLOB/TEXT value in a different row, and seek to its beginning.
+      // This allows iterating over the values of many rows without
+      // opening a new stream for each. Only available since SQLite 3.7.4.
+      //
+#if SQLITE_VERSION_NUMBER >= 3007004
+      void
+      reopen (long long rowid);
+#endif
+
+    protected:
+      virtual int_type
+      underflow ();
+
+      virtual int_type
+      overflow (int_type);
+
+      virtual int
+      sync ();
+
+      virtual std::streamsize
+      showmanyc ();
+
+      virtual std::streamsize
+      xsgetn (char_type*, std::streamsize);
+
+      virtual std::streamsize
+      xsputn (const char_type*, std::streamsize);
+
+      virtual pos_type
+      seekoff (off_type, std::ios_base::seekdir, std::ios_base::openmode);
+
+      virtual pos_type
+      seekpos (pos_type, std::ios_base::openmode);
+
+    private:
+      stream_buffer (const stream_buffer&);
+      stream_buffer& operator= (const stream_buffer&);
+
+    private:
+      // Write the put area, if any, and reset the get and put areas,
+      // moving offset_ to the current position.
+      //
+      void
+      flush ();
+
+      // Current position in the value.
+      //
+      std::size_t
+      position () const;
+
+    private:
+      stream& s_;
+      std::size_t chunk_;
+      details::buffer buf_;
+
+      // Offset in the value of the beginning of the get or put area or,
+      // if neither is set, of the current position.
+      //
+      std::size_t offset_;
+    };
+  }
+}
+
+#include <odb/post.hxx>
+
+#endif // ODB_SQLITE_STREAM_BUFFER_HXX
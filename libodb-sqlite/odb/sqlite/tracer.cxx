@@ -30,6 +30,11 @@ namespace odb
     {
     }
 
+    void tracer::
+    executed (connection&, const statement&, const execution_stats&)
+    {
+    }
+
     void tracer::
     prepare (odb::connection& c, const odb::statement& s)
     {
@@ -56,5 +61,15 @@ namespace odb
       deallocate (static_cast<connection&> (c),
                   static_cast<const statement&> (s));
     }
+
+    void tracer::
+    executed (odb::connection& c,
+              const odb::statement& s,
+              const execution_stats& x)
+    {
+      executed (static_cast<connection&> (c),
+                static_cast<const statement&> (s),
+                x);
+    }
   }
 }
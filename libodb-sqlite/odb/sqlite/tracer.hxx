@@ -34,6 +34,11 @@ namespace odb
       virtual void
       deallocate (connection&, const statement&);
 
+      typedef odb::tracer::execution_stats execution_stats;
+
+      virtual void
+      executed (connection&, const statement&, const execution_stats&);
+
     private:
       // Allow these classes to convert sqlite::tracer to odb::tracer.
       //
@@ -52,6 +57,11 @@ namespace odb
 
       virtual void
       deallocate (odb::connection&, const odb::statement&);
+
+      virtual void
+      executed (odb::connection&,
+                const odb::statement&,
+                const execution_stats&);
     };
   }
 }
@@ -62,6 +62,12 @@ namespace odb
         traits::bind (b, id, id_size, i, sk);
       }
 
+      static bool
+      init (image_type& i, const T& o, statement_kind sk)
+      {
+        return traits::init (i, o, sk);
+      }
+
       static void
       init (T& o, const image_type& i, odb::database* db)
       {
@@ -117,6 +123,12 @@ namespace odb
         traits::bind (b, id, id_size, i, sk, svm_);
       }
 
+      bool
+      init (image_type& i, const T& o, statement_kind sk) const
+      {
+        return traits::init (i, o, sk, svm_);
+      }
+
       void
       init (T& o, const image_type& i, odb::database* db) const
       {
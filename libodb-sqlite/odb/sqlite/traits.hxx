@@ -18,6 +18,10 @@
 #  include <array>
 #endif
 
+#ifdef ODB_CXX17
+#  include <string_view>
+#endif
+
 #include <odb/traits.hxx>
 #include <odb/wrapper-traits.hxx>
 
@@ -60,7 +64,30 @@ namespace odb
     };
 
     template <typename T>
-    struct image_traits<T, id_blob> {typedef details::buffer image_type;};
+    struct image_traits<T, id_blob>
+    {
+      typedef details::buffer image_type;
+      static const bind::buffer_type bind_value = bind::blob;
+    };
+
+#ifdef ODB_CXX17
+    // std::string_view is bound as a view of the column data rather than
+    // copied into a buffer (see view_buffer).
+    //
+    template <>
+    struct image_traits<std::string_view, id_text>
+    {
+      typedef view_buffer image_type;
+      static const bind::buffer_type bind_value = bind::text_view;
+    };
+
+    template <>
+    struct image_traits<std::string_view, id_blob>
+    {
+      typedef view_buffer image_type;
+      static const bind::buffer_type bind_value = bind::blob_view;
+    };
+#endif
 
     template <typename T>
     struct image_traits<T, id_text_stream>
@@ -344,6 +371,71 @@ namespace odb
     struct default_value_traits<const char*, id_text>:
       c_string_value_traits {};
 
+#ifdef ODB_CXX17
+    // std::string_view specialization. The value loaded from the database
+    // points directly to the result data and is only valid until the next
+    // row is fetched or the statement is re-executed. The image is also
+    // initialized without copying the data except for query parameters
+    // which are copied since they may outlive the value.
+    //
+    struct string_view_value_traits
+    {
+      typedef std::string_view value_type;
+      typedef std::string_view query_type;
+      typedef view_buffer image_type;
+
+      static void
+      set_value (std::string_view& v,
+                 const view_buffer& b,
+                 std::size_t n,
+                 bool is_null)
+      {
+        if (!is_null)
+          v = std::string_view (b.data (), n);
+        else
+          v = std::string_view ();
+      }
+
+      static void
+      set_image (view_buffer& b,
+                 std::size_t& n,
+                 bool& is_null,
+                 std::string_view v)
+      {
+        is_null = false;
+        n = v.size ();
+
+        // NULL data pointer would be bound as NULL value.
+        //
+        b.data (v.data () != 0 ? v.data () : "");
+      }
+
+      static void
+      set_image (details::buffer& b,
+                 std::size_t& n,
+                 bool& is_null,
+                 std::string_view v)
+      {
+        is_null = false;
+        n = v.size ();
+
+        if (n > b.capacity ())
+          b.capacity (n);
+
+        if (n != 0)
+          std::memcpy (b.data (), v.data (), n);
+      }
+    };
+
+    template <>
+    struct default_value_traits<std::string_view, id_text>:
+      string_view_value_traits {};
+
+    template <>
+    struct default_value_traits<std::string_view, id_blob>:
+      string_view_value_traits {};
+#endif
+
     // char[N] specialization.
     //
     struct LIBODB_SQLITE_EXPORT c_array_value_traits_base
@@ -1032,6 +1124,14 @@ namespace odb
       static const database_type_id db_type_id = id_text;
     };
 
+#ifdef ODB_CXX17
+    template <>
+    struct default_type_traits<std::string_view>
+    {
+      static const database_type_id db_type_id = id_text;
+    };
+#endif
+
     template <std::size_t N>
     struct default_type_traits<char[N]>
     {
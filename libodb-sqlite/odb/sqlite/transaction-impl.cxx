@@ -34,11 +34,18 @@ namespace odb
     void transaction_impl::
     start ()
     {
-      // Grab a connection if we don't already have one.
+      // Grab a connection if we don't already have one. A deferred
+      // transaction starts as a read transaction so let the connection
+      // factory hand out a connection for reading.
       //
       if (connection_ == 0)
       {
-        connection_ = static_cast<database_type&> (database_).connection ();
+        database_type& db (static_cast<database_type&> (database_));
+
+        connection_ = lock_ == deferred
+          ? db.read_connection ()
+          : db.connection ();
+
         odb::transaction_impl::connection_ = connection_.get ();
       }
 
@@ -61,6 +61,10 @@ namespace odb
 
       using base_type::current;
 
+    private:
+      void
+      cache_rows ();
+
     private:
       // We need to hold on to the query parameters because SQLite uses
       // the parameter buffers to find each next row.
@@ -69,6 +73,7 @@ namespace odb
       details::shared_ptr<select_statement> statement_;
       statements_type& statements_;
       view_traits_calls<view_type> tc_;
+      bool cache_;
     };
   }
 }
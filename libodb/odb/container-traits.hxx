@@ -6,6 +6,8 @@
 
 #include <odb/pre.hxx>
 
+#include <vector>
+
 #include <odb/forward.hxx>
 #include <odb/details/config.hxx> // ODB_CXX11
 
@@ -109,10 +111,24 @@ namespace odb
       delete__ (start_index, data_);
     }
 
+    // Append the key that identifies the object owning the container
+    // (its type and id) to the argument. Return false if the database
+    // runtime does not support this.
+    //
+    bool
+    owner (std::vector<char>& key) const
+    {
+      if (owner_ == 0)
+        return false;
+
+      owner_ (key, data_);
+      return true;
+    }
+
     // Implementation details.
     //
   public:
-    smart_ordered_functions (void* data) : data_ (data) {}
+    smart_ordered_functions (void* data) : data_ (data), owner_ (0) {}
 
   public:
     void* data_;
@@ -121,6 +137,7 @@ namespace odb
     bool (*select_) (I&, V&, void*);
     void (*update_) (I, const V&, void*);
     void (*delete__) (I, void*);
+    void (*owner_) (std::vector<char>&, void*);
   };
 
   // Set/multiset containers.
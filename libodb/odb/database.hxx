@@ -170,6 +170,17 @@ namespace odb
     bool
     find (const typename object_traits<T>::id_type& id, T& object);
 
+    // Load several objects by id with a small number of statements. For
+    // each id in the [ids_begin, ids_end) range, in order, write to out
+    // the object pointer or, if there is no object with this id, the
+    // NULL pointer. Return the number of objects found. Objects that
+    // are already in the session are not loaded again. The range should
+    // not contain duplicate ids.
+    //
+    template <typename T, typename I, typename O>
+    std::size_t
+    load (I ids_begin, I ids_end, O out);
+
     // Update the state of a modified objects.
     //
     template <typename T>
@@ -215,6 +226,24 @@ namespace odb
     void
     update (const T& object, const section&);
 
+    // Persist the object if there is no object with the same id in the
+    // database and update it otherwise, using a single statement. Throw
+    // object_changed if the object has optimistic concurrency and its
+    // version does not match the one in the database. Only supported by
+    // some databases and only for objects that are updated as a whole
+    // (no readonly members, sections, etc).
+    //
+    template <typename T>
+    void
+    upsert (T& object);
+
+    // Bulk upsert. Can be a range of references or pointers (including
+    // smart pointers) to objects.
+    //
+    template <typename I>
+    void
+    upsert (I begin, I end, bool continue_failed = true);
+
     // Make the object transient. Throw object_not_persistent if not
     // found.
     //
@@ -578,6 +607,10 @@ namespace odb
     bool
     find_ (const typename object_traits<T>::id_type&, T&);
 
+    template <typename T, database_id DB, typename I, typename O>
+    std::size_t
+    load_ (I, I, O);
+
     template <typename T, database_id DB>
     void
     update_ (T&);
@@ -594,6 +627,14 @@ namespace odb
     void
     update_ (const T&, const section&);
 
+    template <typename T, database_id DB>
+    void
+    upsert_ (T&);
+
+    template <typename I, database_id DB>
+    void
+    upsert_ (I, I, bool);
+
     template <typename T, database_id DB>
     void
     erase_ (const typename object_traits<T>::id_type&);
@@ -279,6 +279,13 @@ namespace odb
     return find_<T, id_common> (id, obj);
   }
 
+  template <typename T, typename I, typename O>
+  inline std::size_t database::
+  load (I b, I e, O out)
+  {
+    return load_<T, id_common> (b, e, out);
+  }
+
   template <typename T>
   inline void database::
   reload (T& obj)
@@ -419,6 +426,20 @@ namespace odb
     update_<T, id_common> (obj, s);
   }
 
+  template <typename T>
+  inline void database::
+  upsert (T& obj)
+  {
+    upsert_<T, id_common> (obj);
+  }
+
+  template <typename I>
+  inline void database::
+  upsert (I b, I e, bool cont)
+  {
+    upsert_<I, id_common> (b, e, cont);
+  }
+
   template <typename T>
   inline void database::
   erase (const typename object_traits<T>::id_type& id)
@@ -738,7 +759,7 @@ namespace odb
 
     typedef object_pointer_traits<value_type> opt;
 
-    persist_<I, typename opt::object_type, id_common> (
+    persist_<I, typename opt::object_type, DB> (
       b, e, cont, typename opt::result_type ());
   }
 
@@ -778,6 +799,20 @@ namespace odb
     object_traits_impl<object_type, DB>::update (*this, obj);
   }
 
+  template <typename T, database_id DB>
+  inline void database::
+  upsert_ (T& obj)
+  {
+    // T can be const T while object_type will always be T.
+    //
+    typedef typename object_traits<T>::object_type object_type;
+
+    // Compiler error pointing here? Perhaps the object or the database
+    // does not support upsert?
+    //
+    object_traits_impl<object_type, DB>::upsert (*this, obj);
+  }
+
   template <typename T, database_id DB>
   inline void database::
   update_ (const typename object_traits<T>::pointer_type& pobj)
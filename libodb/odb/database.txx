@@ -276,6 +276,113 @@ namespace odb
       throw object_not_persistent ();
   }
 
+  template <typename T, database_id DB, typename I, typename O>
+  std::size_t database::
+  load_ (I b, I e, O out)
+  {
+    // T is always object_type.
+    //
+    typedef object_traits_impl<T, DB> object_traits;
+    typedef typename object_traits::id_type id_type;
+    typedef typename object_traits::pointer_type pointer_type;
+    typedef typename object_traits::pointer_cache_traits cache_traits;
+
+    // The maximum number of ids looked up with a single statement. Note
+    // that databases limit the number of parameters in a statement.
+    //
+    const std::size_t batch (64);
+
+    std::size_t r (0);
+
+    while (b != e)
+    {
+      id_type ids[batch];
+      pointer_type objs[batch];
+      const id_type* p[batch]; // Ids of the objects not in the session.
+      std::size_t n (0), m (0);
+
+      for (; b != e && n != batch; ++b, ++n)
+      {
+        ids[n] = *b;
+        objs[n] = cache_traits::find (*this, ids[n]);
+
+        if (pointer_traits<pointer_type>::null_ptr (objs[n]))
+          p[m++] = ids + n;
+      }
+
+      // Ids of the objects loaded by this chunk. If loading or writing
+      // the objects fails, then remove them from the session and free
+      // those that haven't been written yet, the same as load() does for
+      // a single object.
+      //
+      const id_type* l[batch];
+      std::size_t k (0), w (0);
+
+      try
+      {
+        if (m != 0)
+        {
+          // Compiler error pointing here? Perhaps the object doesn't have
+          // a simple object id or the database does not support loading
+          // several objects at once?
+          //
+          result<T> res (object_traits::find (*this, p, m));
+
+          // The rows come in an unspecified order so match each of them
+          // to its id.
+          //
+          for (typename result<T>::iterator i (res.begin ());
+               i != res.end ();
+               ++i)
+          {
+            id_type id (i.id ());
+
+            for (std::size_t j (0); j != m; ++j)
+            {
+              if (*p[j] == id)
+              {
+                objs[p[j] - ids] = i.load ();
+                l[k++] = p[j];
+                break;
+              }
+            }
+          }
+        }
+
+        for (std::size_t j (0); j != n; ++j)
+        {
+          if (!pointer_traits<pointer_type>::null_ptr (objs[j]))
+            r++;
+
+#ifdef ODB_CXX11
+          *out++ = std::move (objs[j]);
+#else
+          *out++ = objs[j];
+#endif
+          w++;
+        }
+      }
+      catch (...)
+      {
+        for (std::size_t j (0); j != k; ++j)
+        {
+          std::size_t x (static_cast<std::size_t> (l[j] - ids));
+
+          cache_traits::erase (*this, *l[j]);
+
+          if (x >= w)
+          {
+            typename pointer_traits<pointer_type>::guard g (objs[x]);
+          }
+        }
+
+        throw;
+      }
+    }
+
+    return r;
+  }
+
   template <typename I, database_id DB>
   void database::
   update_ (I b, I e, bool cont)
@@ -358,6 +465,68 @@ namespace odb
       throw section_not_in_object ();
   }
 
+  template <typename I, database_id DB>
+  void database::
+  upsert_ (I b, I e, bool cont)
+  {
+    // Sun CC with non-standard STL does not have iterator_traits.
+    //
+#ifndef _RWSTD_NO_CLASS_PARTIAL_SPEC
+    typedef typename std::iterator_traits<I>::value_type value_type;
+#else
+    // Assume iterator is just a pointer.
+    //
+    typedef typename object_pointer_traits<I>::object_type value_type;
+#endif
+
+    // object_pointer_traits<T>::object_type can be const.
+    //
+    typedef object_pointer_traits<value_type> opt;
+
+    typedef
+    typename object_traits<typename opt::object_type>::object_type
+    object_type;
+
+    typedef object_traits_impl<object_type, DB> object_traits;
+
+    // There is no batch version of upsert (each object is a separate
+    // statement execution anyway) so we upsert the objects one by one
+    // and collect the object_changed exceptions.
+    //
+    multiple_exceptions mex (typeid (object_changed));
+
+    try
+    {
+      for (std::size_t n (0); b != e && (cont || mex.empty ()); ++n)
+      {
+        mex.current (n);
+        mex.attempted (n + 1);
+
+        try
+        {
+          // Compiler error pointing here? Perhaps the object or the
+          // database does not support upsert?
+          //
+          object_traits::upsert (*this, opt::get_ref (*b++));
+        }
+        catch (const object_changed& ex)
+        {
+          mex.insert (ex);
+        }
+      }
+    }
+    catch (const odb::exception& ex)
+    {
+      mex.insert (ex, true);
+    }
+
+    if (!mex.empty ())
+    {
+      mex.prepare ();
+      throw mex;
+    }
+  }
+
   template <typename I, typename T, database_id DB>
   void database::
   erase_id_ (I b, I e, bool cont)
@@ -50,6 +50,14 @@
 #  endif
 #endif
 
+// C++17 support.
+//
+#ifdef ODB_CXX11
+#  if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#    define ODB_CXX17
+#  endif
+#endif
+
 #ifdef ODB_CXX11_NOEXCEPT
 #  define ODB_NOTHROW_NOEXCEPT noexcept
 #else
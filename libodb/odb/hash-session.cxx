@@ -0,0 +1,128 @@
+// file      : odb/hash-session.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/details/config.hxx> // ODB_CXX11
+
+#ifdef ODB_CXX11
+
+#include <map>
+
+#include <odb/exceptions.hxx>
+#include <odb/hash-session.hxx>
+
+#include <odb/details/tls.hxx>
+#include <odb/details/lock.hxx>
+#include <odb/details/mutex.hxx>
+#include <odb/details/type-info.hxx>
+
+namespace odb
+{
+  using namespace details;
+
+  static ODB_TLS_POINTER (hash_session) current_hash_session;
+
+  hash_session::
+  hash_session (bool make_current)
+      : hits_ (0), misses_ (0)
+  {
+    if (make_current)
+    {
+      if (has_current ())
+        throw already_in_session ();
+
+      current_pointer (this);
+    }
+  }
+
+  hash_session::
+  ~hash_session ()
+  {
+    // If we are the current thread's session, reset it.
+    //
+    if (current_pointer () == this)
+      reset_current ();
+  }
+
+  hash_session* hash_session::
+  current_pointer ()
+  {
+    return tls_get (current_hash_session);
+  }
+
+  void hash_session::
+  current_pointer (hash_session* s)
+  {
+    tls_set (current_hash_session, s);
+  }
+
+  hash_session& hash_session::
+  current ()
+  {
+    hash_session* cur (tls_get (current_hash_session));
+
+    if (cur == 0)
+      throw not_in_session ();
+
+    return *cur;
+  }
+
+  std::size_t hash_session::
+  allocate_slot (const std::type_info& ti)
+  {
+    typedef std::map<const std::type_info*,
+                     std::size_t,
+                     type_info_comparator> slot_map;
+
+    static mutex m;
+    static slot_map slots;
+
+    lock l (m);
+
+    slot_map::iterator i (slots.find (&ti));
+
+    if (i == slots.end ())
+      i = slots.insert (slot_map::value_type (&ti, slots.size ())).first;
+
+    return i->second;
+  }
+
+  void hash_session::
+  clear ()
+  {
+    db_map_.clear ();
+  }
+
+  hash_session::statistics hash_session::
+  stats () const
+  {
+    statistics r;
+    r.objects = 0;
+    r.hits = hits_;
+    r.misses = misses_;
+
+    for (database_map::const_iterator i (db_map_.begin ());
+         i != db_map_.end ();
+         ++i)
+    {
+      for (type_map::const_iterator j (i->maps.begin ());
+           j != i->maps.end ();
+           ++j)
+      {
+        if (*j)
+          r.objects += (*j)->size ();
+      }
+    }
+
+    return r;
+  }
+
+  //
+  // object_map_base
+  //
+  hash_session::object_map_base::
+  ~object_map_base ()
+  {
+  }
+}
+
+#endif // ODB_CXX11
@@ -0,0 +1,326 @@
+// file      : odb/hash-session.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_HASH_SESSION_HXX
+#define ODB_HASH_SESSION_HXX
+
+#include <odb/pre.hxx>
+
+#include <odb/details/config.hxx> // ODB_CXX11
+
+#ifdef ODB_CXX11
+
+#include <vector>
+#include <memory>     // std::unique_ptr
+#include <cstddef>    // std::size_t
+#include <typeinfo>
+#include <functional> // std::hash
+
+#include <odb/traits.hxx>
+#include <odb/forward.hxx>
+#include <odb/snapshot-store.hxx>
+
+#include <odb/details/export.hxx>
+
+namespace odb
+{
+  // Object id hash function used by hash_session. Specialize it for id
+  // types that are not supported by std::hash, such as composite ids.
+  //
+  template <typename T>
+  struct session_id_hash: std::hash<T> {};
+
+  // Alternative session implementation that can be used instead of
+  // odb::session (see the --session-type ODB compiler option). Instead of
+  // nested std::map's, objects are cached in open-addressing hash tables
+  // and the per-type table is located using a slot index that is assigned
+  // to each type once rather than by looking up its std::type_info. It
+  // also keeps cache hit/miss statistics.
+  //
+  // Note that the object id type must be supported by session_id_hash.
+  //
+  class LIBODB_EXPORT hash_session
+  {
+  public:
+    typedef odb::database database_type;
+
+    // If the make_current argument is true, then set the current thread's
+    // session to this session. If another session is already in effect,
+    // throw the already_in_session exception.
+    //
+    hash_session (bool make_current = true);
+
+    // Reset the current thread's session if it is this session.
+    //
+    ~hash_session ();
+
+    // Current session.
+    //
+  public:
+    // Return true if there is a session in effect in the current
+    // thread.
+    //
+    static bool
+    has_current () {return current_pointer () != 0;}
+
+    // Get current thread's session. Throw if no session is in effect.
+    //
+    static hash_session&
+    current ();
+
+    // Set current thread's session.
+    //
+    static void
+    current (hash_session& s) {current_pointer (&s);}
+
+    // Revert to the no session in effect state for the current thread.
+    //
+    static void
+    reset_current () {current_pointer (0);}
+
+    // Pointer versions.
+    //
+    static hash_session*
+    current_pointer ();
+
+    static void
+    current_pointer (hash_session*);
+
+    // Copying or assignment of sessions is not supported.
+    //
+  private:
+    hash_session (const hash_session&);
+    hash_session& operator= (const hash_session&);
+
+  public:
+    struct LIBODB_EXPORT object_map_base
+    {
+      virtual
+      ~object_map_base ();
+
+      // Number of objects in the map.
+      //
+      virtual std::size_t
+      size () const = 0;
+    };
+
+    template <typename T>
+    class object_map;
+
+    // Object cache.
+    //
+  public:
+    // Position in the cache of the inserted element.
+    //
+    template <typename T>
+    struct cache_position;
+
+    template <typename T>
+    cache_position<T>
+    cache_insert (database_type&,
+                  const typename object_traits<T>::id_type&,
+                  const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    typename object_traits<T>::pointer_type
+    cache_find (database_type&,
+                const typename object_traits<T>::id_type&) const;
+
+    template <typename T>
+    void
+    cache_erase (const cache_position<T>&);
+
+    template <typename T>
+    void
+    cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+    // Remove all the objects from the cache. Note that this invalidates
+    // all the cache positions.
+    //
+    void
+    clear ();
+
+    // Cache statistics.
+    //
+  public:
+    struct statistics
+    {
+      std::size_t objects;     // Number of cached objects.
+      unsigned long long hits;   // Number of successful cache_find() calls.
+      unsigned long long misses; // Number of failed cache_find() calls.
+    };
+
+    statistics
+    stats () const;
+
+    // Container and object snapshots (see odb/snapshot-store.hxx).
+    //
+  public:
+    snapshot_store&
+    snapshots () {return snapshots_;}
+
+    // Static cache API as expected by the rest of ODB.
+    //
+  public:
+    static bool
+    _has_cache () {return has_current ();}
+
+    // Position in the cache of the inserted element. Unlike a hash table
+    // slot, the entry index stays valid when the table is grown.
+    //
+    template <typename T>
+    struct cache_position
+    {
+      typedef hash_session::object_map<T> map;
+
+      cache_position (): map_ (0), pos_ (0) {}
+      cache_position (map& m, std::size_t p): map_ (&m), pos_ (p) {}
+
+      map* map_;
+      std::size_t pos_;
+    };
+
+    template <typename T>
+    static cache_position<T>
+    _cache_insert (database_type&,
+                   const typename object_traits<T>::id_type&,
+                   const typename object_traits<T>::pointer_type&);
+
+    template <typename T>
+    static typename object_traits<T>::pointer_type
+    _cache_find (database_type&, const typename object_traits<T>::id_type&);
+
+    template <typename T>
+    static void
+    _cache_erase (const cache_position<T>&);
+
+    // Notifications. These are called after per-object callbacks for
+    // post_{persist, load, update, erase} events.
+    //
+    template <typename T>
+    static void
+    _cache_persist (const cache_position<T>&) {}
+
+    template <typename T>
+    static void
+    _cache_load (const cache_position<T>&) {}
+
+    template <typename T>
+    static void
+    _cache_update (database_type&, const T&) {}
+
+    template <typename T>
+    static void
+    _cache_erase (database_type&, const typename object_traits<T>::id_type&);
+
+  private:
+    // Return the slot index of type T. The index is looked up on the
+    // first call and is the same for all the sessions.
+    //
+    template <typename T>
+    static std::size_t
+    slot ();
+
+    // Return the slot index of the type, allocating it if necessary.
+    // Since the lookup is by std::type_info, each type has the same index
+    // in all the modules (shared libraries) that instantiate slot<T>().
+    //
+    static std::size_t
+    allocate_slot (const std::type_info&);
+
+    template <typename T>
+    object_map<T>*
+    find_map (database_type&) const;
+
+    template <typename T>
+    object_map<T>&
+    insert_map (database_type&);
+
+  private:
+    typedef std::vector<std::unique_ptr<object_map_base>> type_map;
+
+    struct database_entry
+    {
+      database_type* db;
+      type_map maps;
+    };
+
+    // There is normally only one or two databases so we use linear search.
+    //
+    typedef std::vector<database_entry> database_map;
+
+    database_map db_map_;
+
+    mutable unsigned long long hits_;
+    mutable unsigned long long misses_;
+
+    snapshot_store snapshots_;
+  };
+
+  // Open-addressing (linear probing) hash table of objects. The objects
+  // are stored in a separate vector of entries so that their positions
+  // are not affected by growing the table.
+  //
+  template <typename T>
+  class hash_session::object_map: public object_map_base
+  {
+  public:
+    typedef typename object_traits<T>::id_type id_type;
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    static const std::size_t npos = ~std::size_t (0);
+
+    object_map (): size_ (0) {}
+
+    // Insert or update the object returning its entry index.
+    //
+    std::size_t
+    insert (const id_type&, const pointer_type&);
+
+    // Return the entry index or npos if not found.
+    //
+    std::size_t
+    find (const id_type&) const;
+
+    void
+    erase (std::size_t);
+
+    const pointer_type&
+    object (std::size_t i) const {return entries_[i].obj;}
+
+    virtual std::size_t
+    size () const {return size_;}
+
+  private:
+    static std::size_t
+    mix (std::size_t);
+
+    void
+    grow ();
+
+  private:
+    struct entry
+    {
+      entry (const id_type& i, const pointer_type& o, std::size_t h)
+          : id (i), obj (o), hash (h) {}
+
+      id_type id;
+      pointer_type obj;
+      std::size_t hash;
+    };
+
+    std::vector<entry> entries_;
+    std::vector<std::size_t> free_;  // Free entries.
+    std::vector<std::size_t> table_; // Entry index + 1 or 0 if empty.
+    std::size_t size_;
+  };
+}
+
+#include <odb/hash-session.ixx>
+#include <odb/hash-session.txx>
+
+#endif // ODB_CXX11
+
+#include <odb/post.hxx>
+
+#endif // ODB_HASH_SESSION_HXX
@@ -0,0 +1,79 @@
+// file      : odb/hash-session.ixx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  template <typename T>
+  inline std::size_t hash_session::
+  slot ()
+  {
+    static const std::size_t s (allocate_slot (typeid (T)));
+    return s;
+  }
+
+  template <typename T>
+  inline void hash_session::
+  cache_erase (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->erase (p.pos_);
+  }
+
+  template <typename T>
+  inline typename hash_session::cache_position<T> hash_session::
+  _cache_insert (database_type& db,
+                 const typename object_traits<T>::id_type& id,
+                 const typename object_traits<T>::pointer_type& obj)
+  {
+    if (hash_session* s = current_pointer ())
+      return s->cache_insert<T> (db, id, obj);
+    else
+      return cache_position<T> ();
+  }
+
+  template <typename T>
+  inline typename object_traits<T>::pointer_type hash_session::
+  _cache_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (const hash_session* s = current_pointer ())
+      return s->cache_find<T> (db, id);
+    else
+      return pointer_type ();
+  }
+
+  template <typename T>
+  inline void hash_session::
+  _cache_erase (const cache_position<T>& p)
+  {
+    if (p.map_ != 0)
+      p.map_->erase (p.pos_);
+  }
+
+  template <typename T>
+  inline void hash_session::
+  _cache_erase (database_type& db,
+                const typename object_traits<T>::id_type& id)
+  {
+    if (hash_session* s = current_pointer ())
+      s->cache_erase<T> (db, id);
+  }
+
+  //
+  // object_map
+  //
+
+  template <typename T>
+  inline std::size_t hash_session::object_map<T>::
+  mix (std::size_t h)
+  {
+    // std::hash is often the identity function for integers so spread
+    // the bits a bit before masking.
+    //
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+    return h;
+  }
+}
@@ -0,0 +1,248 @@
+// file      : odb/hash-session.txx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  template <typename T>
+  hash_session::object_map<T>* hash_session::
+  find_map (database_type& db) const
+  {
+    for (database_map::const_iterator i (db_map_.begin ());
+         i != db_map_.end ();
+         ++i)
+    {
+      if (i->db == &db)
+      {
+        std::size_t s (slot<T> ());
+
+        return s < i->maps.size ()
+          ? static_cast<object_map<T>*> (i->maps[s].get ())
+          : 0;
+      }
+    }
+
+    return 0;
+  }
+
+  template <typename T>
+  hash_session::object_map<T>& hash_session::
+  insert_map (database_type& db)
+  {
+    database_map::iterator i (db_map_.begin ());
+    for (; i != db_map_.end () && i->db != &db; ++i) ;
+
+    if (i == db_map_.end ())
+    {
+      database_entry e;
+      e.db = &db;
+      db_map_.push_back (std::move (e));
+      i = db_map_.end () - 1;
+    }
+
+    std::size_t s (slot<T> ());
+
+    if (s >= i->maps.size ())
+      i->maps.resize (s + 1);
+
+    std::unique_ptr<object_map_base>& m (i->maps[s]);
+
+    if (!m)
+      m.reset (new object_map<T>);
+
+    return static_cast<object_map<T>&> (*m);
+  }
+
+  template <typename T>
+  typename hash_session::cache_position<T> hash_session::
+  cache_insert (database_type& db,
+                const typename object_traits<T>::id_type& id,
+                const typename object_traits<T>::pointer_type& obj)
+  {
+    object_map<T>& om (insert_map<T> (db));
+
+    // If the object is already in the map (e.g., the user loaded the same
+    // object into two different instances), then insert() updates the
+    // entry (see session::cache_insert() for details).
+    //
+    return cache_position<T> (om, om.insert (id, obj));
+  }
+
+  template <typename T>
+  typename object_traits<T>::pointer_type hash_session::
+  cache_find (database_type& db,
+              const typename object_traits<T>::id_type& id) const
+  {
+    typedef typename object_traits<T>::pointer_type pointer_type;
+
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      std::size_t i (om->find (id));
+
+      if (i != object_map<T>::npos)
+      {
+        hits_++;
+        return om->object (i);
+      }
+    }
+
+    misses_++;
+    return pointer_type ();
+  }
+
+  template <typename T>
+  void hash_session::
+  cache_erase (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    // Empty maps are not cleaned up since there could still be positions
+    // pointing to them.
+    //
+    if (object_map<T>* om = find_map<T> (db))
+    {
+      std::size_t i (om->find (id));
+
+      if (i != object_map<T>::npos)
+        om->erase (i);
+    }
+  }
+
+  //
+  // object_map
+  //
+
+  template <typename T>
+  std::size_t hash_session::object_map<T>::
+  insert (const id_type& id, const pointer_type& obj)
+  {
+    // Keep the load factor under 3/4.
+    //
+    if ((size_ + 1) * 4 > table_.size () * 3)
+      grow ();
+
+    std::size_t h (session_id_hash<id_type> () (id));
+    std::size_t m (table_.size () - 1);
+    std::size_t i (mix (h) & m);
+
+    for (; table_[i] != 0; i = (i + 1) & m)
+    {
+      entry& e (entries_[table_[i] - 1]);
+
+      if (e.hash == h && e.id == id)
+      {
+        e.obj = obj;
+        return table_[i] - 1;
+      }
+    }
+
+    std::size_t r;
+
+    if (!free_.empty ())
+    {
+      r = free_.back ();
+
+      entry& e (entries_[r]);
+      e.id = id;
+      e.obj = obj;
+      e.hash = h;
+
+      free_.pop_back ();
+    }
+    else
+    {
+      // Make sure erase() does not need to allocate.
+      //
+      free_.reserve (entries_.size () + 1);
+
+      r = entries_.size ();
+      entries_.push_back (entry (id, obj, h));
+    }
+
+    table_[i] = r + 1;
+    size_++;
+    return r;
+  }
+
+  template <typename T>
+  std::size_t hash_session::object_map<T>::
+  find (const id_type& id) const
+  {
+    if (size_ == 0)
+      return npos;
+
+    std::size_t h (session_id_hash<id_type> () (id));
+    std::size_t m (table_.size () - 1);
+
+    for (std::size_t i (mix (h) & m); table_[i] != 0; i = (i + 1) & m)
+    {
+      const entry& e (entries_[table_[i] - 1]);
+
+      if (e.hash == h && e.id == id)
+        return table_[i] - 1;
+    }
+
+    return npos;
+  }
+
+  template <typename T>
+  void hash_session::object_map<T>::
+  erase (std::size_t r)
+  {
+    entry& e (entries_[r]);
+    std::size_t m (table_.size () - 1);
+    std::size_t i (mix (e.hash) & m);
+
+    for (; table_[i] != r + 1; i = (i + 1) & m)
+    {
+      if (table_[i] == 0) // Already erased.
+        return;
+    }
+
+    // Shift back the following entries that would otherwise become
+    // unreachable (no tombstones).
+    //
+    for (std::size_t j (i);;)
+    {
+      j = (j + 1) & m;
+
+      if (table_[j] == 0)
+        break;
+
+      // Leave the entry alone if its home slot is cyclically in (i, j].
+      //
+      std::size_t k (mix (entries_[table_[j] - 1].hash) & m);
+
+      if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+        continue;
+
+      table_[i] = table_[j];
+      i = j;
+    }
+
+    table_[i] = 0;
+
+    e.obj = pointer_type ();
+    free_.push_back (r);
+    size_--;
+  }
+
+  template <typename T>
+  void hash_session::object_map<T>::
+  grow ()
+  {
+    std::vector<std::size_t> t (table_.empty () ? 16 : table_.size () * 2, 0);
+    std::size_t m (t.size () - 1);
+
+    for (std::vector<std::size_t>::const_iterator i (table_.begin ());
+         i != table_.end ();
+         ++i)
+    {
+      if (*i != 0)
+      {
+        std::size_t j (mix (entries_[*i - 1].hash) & m);
+        for (; t[j] != 0; j = (j + 1) & m) ;
+        t[j] = *i;
+      }
+    }
+
+    table_.swap (t);
+  }
+}
@@ -6,22 +6,31 @@
 
 #include <odb/pre.hxx>
 
+#include <new>     // placement new
+#include <cstddef> // std::size_t
 #include <utility> // std::move
 
 #include <odb/forward.hxx> // odb::database
 #include <odb/traits.hxx>
 
 #include <odb/details/config.hxx> // ODB_CXX11
+#include <odb/details/unused.hxx>
+
+#ifdef ODB_CXX11
+#  include <type_traits> // std::is_nothrow_move_constructible
+#endif
 
 namespace odb
 {
+  // Note that the id is always allocated on the heap.
+  //
   struct lazy_ptr_impl_ref
   {
     void* id_;
     database* db_;
     void* loader_;
-    void (*free_) (void*);
-    void* (*copy_) (const void*);
+    void (*free_) (void*, bool);
+    void* (*copy_) (const void*, void*, bool);
   };
 
   class lazy_ptr_base
@@ -76,10 +85,19 @@ namespace odb
     operator lazy_ptr_impl_ref ();
 
   protected:
-    typedef void (*free_func) (void*);
-    typedef void* (*copy_func) (const void*);
+    // Small ids (integers, short strings, etc) are stored inline, in
+    // buf_, rather than being allocated on the heap. The free function
+    // is passed true if the id is stored inline in which case it only
+    // destroys it. The copy function constructs a copy of id in the
+    // buffer if one is passed and the id fits and on the heap otherwise.
+    // If the last argument is true, then id is moved rather than copied
+    // (C++11 only).
+    //
+    typedef void (*free_func) (void*, bool);
+    typedef void* (*copy_func) (const void*, void* buf, bool move);
 
-    // Makes a copy of id.
+    // Makes a copy of id. If an exception is thrown while copying, this
+    // object is left unchanged (but see the implementation for C++98).
     //
     void
     reset_ (database_type*,
@@ -89,11 +107,37 @@ namespace odb
 
     template <typename T>
     static void
-    free (void*);
+    free (void*, bool);
 
     template <typename T>
     static void*
-    copy (const void*);
+    copy (const void*, void*, bool);
+
+    union buffer
+    {
+      void* p;
+      long long ll;
+      double d;
+      char data[sizeof (void*) * 4];
+    };
+
+    template <typename T>
+    struct alignment
+    {
+      struct s {char c; T t;};
+      static const std::size_t value = sizeof (s) - sizeof (T);
+    };
+
+    template <typename T>
+    struct inline_id
+    {
+      static const bool value =
+        sizeof (T) <= sizeof (buffer) &&
+#ifdef ODB_CXX11
+        std::is_nothrow_move_constructible<T>::value &&
+#endif
+        alignment<T>::value <= alignment<buffer>::value;
+    };
 
     template <typename T, typename DB>
     static typename object_traits<T>::pointer_type
@@ -104,9 +148,30 @@ namespace odb
     database_type* db_;
     void* loader_;
 
+  private:
+    bool
+    inline_ () const
+    {
+      return id_ == buf_.data;
+    }
+
+    void
+    free_id_ ()
+    {
+      free_ (id_, inline_ ());
+    }
+
+    // Transfer the id from r leaving it without one. This object should
+    // not have an id.
+    //
+    void
+    move_id_ (lazy_ptr_base& r);
+
   private:
     free_func free_;
     copy_func copy_;
+
+    buffer buf_;
   };
 
   template <typename T>
@@ -19,7 +19,7 @@ namespace odb
         free_ (r.free_), copy_ (r.copy_)
   {
     if (r.id_)
-      id_ = copy_ (r.id_);
+      id_ = copy_ (r.id_, buf_.data, false);
   }
 
   inline lazy_ptr_base::
@@ -29,13 +29,28 @@ namespace odb
   {
   }
 
+  inline void lazy_ptr_base::
+  move_id_ (lazy_ptr_base& r)
+  {
+    if (r.id_ != 0 && r.inline_ ())
+    {
+      id_ = r.copy_ (r.id_, buf_.data, true);
+      r.free_id_ ();
+    }
+    else
+      id_ = r.id_;
+
+    free_ = r.free_;
+    copy_ = r.copy_;
+    r.id_ = 0;
+  }
+
 #ifdef ODB_CXX11
   inline lazy_ptr_base::
   lazy_ptr_base (lazy_ptr_base&& r) noexcept
-      : id_ (r.id_), db_ (r.db_), loader_ (r.loader_),
-        free_ (r.free_), copy_ (r.copy_)
+      : id_ (0), db_ (r.db_), loader_ (r.loader_)
   {
-    r.id_ = 0;
+    move_id_ (r);
   }
 #endif
 
@@ -43,7 +58,7 @@ namespace odb
   reset_id ()
   {
     if (id_)
-      free_ (id_);
+      free_id_ ();
 
     id_ = 0;
   }
@@ -55,17 +70,41 @@ namespace odb
           free_func free,
           copy_func copy)
   {
-    void* idc (id ? copy (id) : 0);
+    // Copy the new id before changing anything so that if the copy
+    // throws, we are left intact. Since the new id may have to end up in
+    // the same buffer as the old one, an inline id is first copied into
+    // a temporary buffer and then moved into ours once the old id has
+    // been freed.
+    //
+    buffer b;
+    void* p (id != 0 ? copy (id, b.data, false) : 0);
 
-    if (id_)
-      free_ (id_);
+    reset_id ();
 
-    free_ = free;
-    copy_ = copy;
+    if (p == b.data)
+    {
+      // Moving an inline id cannot throw in C++11 (see inline_id) but in
+      // C++98 it is copied. In this case the id is left reset.
+      //
+      try
+      {
+        id_ = copy (p, buf_.data, true);
+      }
+      catch (...)
+      {
+        free (p, true);
+        throw;
+      }
+
+      free (p, true);
+    }
+    else
+      id_ = p;
 
-    id_ = idc;
     db_ = db;
     loader_ = loader;
+    free_ = free;
+    copy_ = copy;
   }
 
   inline void lazy_ptr_base::
@@ -83,11 +122,7 @@ namespace odb
     if (id_ != r.id_)
     {
       reset_id ();
-      id_ = r.id_;
-      free_ = r.free_;
-      copy_ = r.copy_;
-
-      r.id_ = 0;
+      move_id_ (r);
     }
 
     db_ = r.db_;
@@ -130,29 +165,27 @@ namespace odb
   ~lazy_ptr_base ()
   {
     if (id_)
-      free_ (id_);
+      free_id_ ();
   }
 
   inline void lazy_ptr_base::
   swap (lazy_ptr_base& r)
   {
-    void* id (id_);
     database_type* db (db_);
     void* l (loader_);
-    free_func f (free_);
-    copy_func c (copy_);
 
-    id_ = r.id_;
+    // Ids stored inline cannot simply be exchanged.
+    //
+    lazy_ptr_base t;
+    t.move_id_ (*this);
+    move_id_ (r);
+    r.move_id_ (t);
+
     db_ = r.db_;
     loader_ = r.loader_;
-    free_ = r.free_;
-    copy_ = r.copy_;
 
-    r.id_ = id;
     r.db_ = db;
     r.loader_ = l;
-    r.free_ = f;
-    r.copy_ = c;
   }
 
   inline lazy_ptr_base::database_type* lazy_ptr_base::
@@ -165,7 +198,18 @@ namespace odb
   operator lazy_ptr_impl_ref ()
   {
     lazy_ptr_impl_ref r;
-    r.id_ = id_;
+
+    // The reference may outlive us so move the id to the heap if it is
+    // stored inline.
+    //
+    if (id_ != 0 && inline_ ())
+    {
+      r.id_ = copy_ (id_, 0, false);
+      free_id_ ();
+    }
+    else
+      r.id_ = id_;
+
     r.db_ = db_;
     r.loader_ = loader_;
     r.free_ = free_;
@@ -9,15 +9,30 @@ namespace odb
 
   template <typename T>
   void lazy_ptr_base::
-  free (void* p)
+  free (void* p, bool inl)
   {
-    delete static_cast<T*> (p);
+    if (inl)
+      static_cast<T*> (p)->~T ();
+    else
+      delete static_cast<T*> (p);
   }
 
   template <typename T>
   void* lazy_ptr_base::
-  copy (const void* p)
+  copy (const void* p, void* buf, bool move)
   {
+    if (buf != 0 && inline_id<T>::value)
+    {
+#ifdef ODB_CXX11
+      if (move)
+        return new (buf) T (
+          std::move (*static_cast<T*> (const_cast<void*> (p))));
+#else
+      ODB_POTENTIALLY_UNUSED (move);
+#endif
+      return new (buf) T (*static_cast<const T*> (p));
+    }
+
     return new T (*static_cast<const T*> (p));
   }
 
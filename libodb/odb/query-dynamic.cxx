@@ -3,10 +3,15 @@
 
 #include <odb/query-dynamic.hxx>
 
+#include <odb/details/lock.hxx>
+#include <odb/details/mutex.hxx>
+
 using namespace std;
 
 namespace odb
 {
+  using details::lock;
+
   // query_param
   //
   query_param::
@@ -14,6 +19,184 @@ namespace odb
   {
   }
 
+  // query_translation
+  //
+  query_translation::
+  ~query_translation ()
+  {
+  }
+
+  // query_translation_cache
+  //
+  struct query_translation_cache::node: details::shared_base
+  {
+    node ()
+    {
+      for (size_t i (0); i != database_count; ++i)
+        translations[i] = 0;
+    }
+
+    ~node ()
+    {
+      for (size_t i (0); i != database_count; ++i)
+      {
+        if (query_translation* t = translations[i])
+          details::dec_ref (t);
+      }
+    }
+
+#ifdef ODB_CXX11
+    atomic<query_translation*> translations[database_count];
+#else
+    query_translation* translations[database_count];
+#endif
+  };
+
+#ifdef ODB_CXX11
+  query_translation_cache::
+  query_translation_cache (const query_translation_cache& x)
+  {
+    node* n (x.node_.load (memory_order_acquire));
+
+    if (n != 0)
+      details::inc_ref (n);
+
+    node_.store (n, memory_order_relaxed);
+  }
+
+  query_translation_cache& query_translation_cache::
+  operator= (const query_translation_cache& x)
+  {
+    if (this != &x)
+    {
+      node* n (x.node_.load (memory_order_acquire));
+
+      if (n != 0)
+        details::inc_ref (n);
+
+      reset ();
+      node_.store (n, memory_order_relaxed);
+    }
+
+    return *this;
+  }
+
+  void query_translation_cache::
+  reset ()
+  {
+    if (node* n = node_.load (memory_order_relaxed))
+    {
+      node_.store (0, memory_order_relaxed);
+      details::dec_ref (n);
+    }
+  }
+
+  details::shared_ptr<query_translation> query_translation_cache::
+  get (database_id db) const
+  {
+    // Neither the node nor the translation can go away while this object
+    // is not modified.
+    //
+    if (node* n = node_.load (memory_order_acquire))
+    {
+      if (query_translation* t =
+          n->translations[db].load (memory_order_acquire))
+        return details::shared_ptr<query_translation> (details::inc_ref (t));
+    }
+
+    return details::shared_ptr<query_translation> ();
+  }
+
+  void query_translation_cache::
+  set (database_id db, const details::shared_ptr<query_translation>& t) const
+  {
+    node* n (node_.load (memory_order_acquire));
+
+    if (n == 0)
+    {
+      node* x (new (details::shared) node);
+
+      // If another thread has beaten us to it, use its node.
+      //
+      if (node_.compare_exchange_strong (n, x, memory_order_acq_rel))
+        n = x;
+      else
+        details::dec_ref (x);
+    }
+
+    query_translation* e (0);
+    query_translation* p (details::inc_ref (t.get ()));
+
+    if (!n->translations[db].compare_exchange_strong (
+          e, p, memory_order_acq_rel))
+      details::dec_ref (p);
+  }
+#else
+  // Protects the cached translations of all the queries. It is only held
+  // while copying the pointers so a single mutex should be sufficient.
+  //
+  static details::mutex translation_mutex_;
+
+  query_translation_cache::
+  query_translation_cache (const query_translation_cache& x)
+  {
+    lock l (translation_mutex_);
+
+    if ((node_ = x.node_) != 0)
+      details::inc_ref (node_);
+  }
+
+  query_translation_cache& query_translation_cache::
+  operator= (const query_translation_cache& x)
+  {
+    if (this != &x)
+    {
+      reset ();
+
+      lock l (translation_mutex_);
+
+      if ((node_ = x.node_) != 0)
+        details::inc_ref (node_);
+    }
+
+    return *this;
+  }
+
+  void query_translation_cache::
+  reset ()
+  {
+    if (node_ != 0)
+    {
+      lock l (translation_mutex_);
+      details::dec_ref (node_);
+      node_ = 0;
+    }
+  }
+
+  details::shared_ptr<query_translation> query_translation_cache::
+  get (database_id db) const
+  {
+    lock l (translation_mutex_);
+
+    query_translation* t (node_ != 0 ? node_->translations[db] : 0);
+
+    return details::shared_ptr<query_translation> (
+      t != 0 ? details::inc_ref (t) : 0);
+  }
+
+  void query_translation_cache::
+  set (database_id db, const details::shared_ptr<query_translation>& t) const
+  {
+    lock l (translation_mutex_);
+
+    if (node_ == 0)
+      node_ = new (details::shared) node;
+
+    if (node_->translations[db] == 0)
+      node_->translations[db] = details::inc_ref (t.get ());
+  }
+#endif
+
   // query_base
   //
   void query_base::
@@ -33,11 +216,13 @@ namespace odb
 
     clause_.clear ();
     strings_.clear ();
+    reset_translations ();
   }
 
   void query_base::
   append (const string& native)
   {
+    reset_translations ();
     strings_.push_back (native);
     clause_.push_back (clause_part ());
     clause_.back ().kind = clause_part::kind_native;
@@ -47,6 +232,8 @@ namespace odb
   void query_base::
   append (const query_base& x)
   {
+    reset_translations ();
+
     size_t i (clause_.size ()), delta (i);
     size_t n (i + x.clause_.size ());
     clause_.resize (n);
@@ -109,6 +296,7 @@ namespace odb
   void query_base::
   append_ref (const void* ref, const native_column_info* c)
   {
+    reset_translations ();
     clause_.push_back (clause_part ());
     clause_part& p (clause_.back ());
 
@@ -120,6 +308,19 @@ namespace odb
       new (details::shared) query_param (ref));
   }
 
+  details::shared_ptr<query_translation> query_base::
+  translation (database_id db) const
+  {
+    return translations_.get (db);
+  }
+
+  void query_base::
+  translation (database_id db,
+               const details::shared_ptr<query_translation>& t) const
+  {
+    translations_.set (db, t);
+  }
+
   query_base& query_base::
   operator+= (const std::string& native)
   {
@@ -13,9 +13,14 @@
 #include <odb/forward.hxx>
 #include <odb/query.hxx>
 
+#include <odb/details/config.hxx> // ODB_CXX11
 #include <odb/details/export.hxx>
 #include <odb/details/shared-ptr.hxx>
 
+#ifdef ODB_CXX11
+#  include <atomic>
+#endif
+
 namespace odb
 {
   struct native_column_info;
@@ -91,6 +96,60 @@ namespace odb
     T copy;
   };
 
+  // Translation of the dynamic query to the native query of a specific
+  // database. The database runtimes derive from this class in order to
+  // cache the translation in query_base so that it doesn't have to be
+  // redone every time the query is executed.
+  //
+  struct LIBODB_EXPORT query_translation: details::shared_base
+  {
+    virtual
+    ~query_translation ();
+  };
+
+  // Cached translations of a query, one per database. The translations
+  // are kept in a reference-counted node that is shared by the query
+  // copies. Each translation in the node is set at most once and the node
+  // is not modified in any other way. As a result, in C++11 copies can
+  // share the node and the translations can be looked up and set without
+  // locking. In C++98 these operations are serialized with a mutex.
+  //
+  class LIBODB_EXPORT query_translation_cache
+  {
+  public:
+    query_translation_cache (): node_ (0) {}
+
+    query_translation_cache (const query_translation_cache&);
+
+    query_translation_cache&
+    operator= (const query_translation_cache&);
+
+    ~query_translation_cache () {reset ();}
+
+    // Release the node. Should not be called concurrently with any other
+    // function on this object.
+    //
+    void
+    reset ();
+
+    details::shared_ptr<query_translation>
+    get (database_id) const;
+
+    // If the translation has already been set, then keep the existing one.
+    //
+    void
+    set (database_id, const details::shared_ptr<query_translation>&) const;
+
+  private:
+    struct node;
+
+#ifdef ODB_CXX11
+    mutable std::atomic<node*> node_;
+#else
+    mutable node* node_;
+#endif
+  };
+
   //
   //
   class LIBODB_EXPORT query_base
@@ -183,6 +242,7 @@ namespace odb
     query_base (const query_base& x)
     {
       append (x);
+      translations_ = x.translations_;
     }
 
     query_base&
@@ -192,6 +252,7 @@ namespace odb
       {
         clear ();
         append (x);
+        translations_ = x.translations_;
       }
 
       return *this;
@@ -272,6 +333,7 @@ namespace odb
     void
     append (clause_part::kind_type k, std::size_t data)
     {
+      reset_translations ();
       clause_.push_back (clause_part ());
       clause_.back ().kind = k;
       clause_.back ().data = data;
@@ -282,6 +344,7 @@ namespace odb
     void
     append (const native_column_info* c)
     {
+      reset_translations ();
       clause_.push_back (clause_part ());
       clause_.back ().kind = clause_part::kind_column;
       clause_.back ().native_info = c;
@@ -315,9 +378,30 @@ namespace odb
       return strings_;
     }
 
+    // Cached translation to the native query of the specified database
+    // or NULL if there is none. The translations are discarded when the
+    // query is modified and are shared by its copies (which also share
+    // the parameters). These functions can be called concurrently on
+    // the same query.
+    //
+    details::shared_ptr<query_translation>
+    translation (database_id) const;
+
+    void
+    translation (database_id,
+                 const details::shared_ptr<query_translation>&) const;
+
+  private:
+    void
+    reset_translations ()
+    {
+      translations_.reset ();
+    }
+
   private:
     clause_type clause_;
     strings_type strings_;
+    query_translation_cache translations_;
   };
 
   inline query_base
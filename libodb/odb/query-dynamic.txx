@@ -11,6 +11,7 @@ namespace odb
   void query_base::
   append_val (const T& val, const native_column_info* c)
   {
+    reset_translations ();
     clause_.push_back (clause_part ());
     clause_part& p (clause_.back ());
 
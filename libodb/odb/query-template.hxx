@@ -0,0 +1,149 @@
+// file      : odb/query-template.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_QUERY_TEMPLATE_HXX
+#define ODB_QUERY_TEMPLATE_HXX
+
+#include <odb/pre.hxx>
+
+#include <memory> // std::auto_ptr, std::unique_ptr
+
+#include <odb/forward.hxx>
+#include <odb/traits.hxx>
+#include <odb/result.hxx>
+#include <odb/query.hxx>
+#include <odb/database.hxx>
+#include <odb/connection.hxx>
+#include <odb/transaction.hxx>
+#include <odb/prepared-query.hxx>
+
+#include <odb/details/config.hxx> // ODB_CXX11
+
+namespace odb
+{
+  // Query template, that is, a query that is translated to SQL and
+  // prepared once per connection and then executed any number of times
+  // with arguments passed by value.
+  //
+  // The query is built by the builder function which is passed the
+  // arguments object of type A and should bind its members by reference
+  // (_ref()). For example:
+  //
+  // struct name_args
+  // {
+  //   std::string first;
+  //   std::string last;
+  // };
+  //
+  // static query<person>
+  // by_name (const name_args& a)
+  // {
+  //   typedef query<person> q;
+  //   return q::first == q::_ref (a.first) && q::last == q::_ref (a.last);
+  // }
+  //
+  // static const query_template<person, name_args> find_by_name (
+  //   "find-by-name", &by_name);
+  //
+  // result<person> r (find_by_name.execute (db, args));
+  //
+  // The first execution on a connection creates the connection's own
+  // arguments object, builds the query with it, prepares the query, and
+  // caches both on the connection (see connection::cache_query()).
+  // Subsequent executions on this connection only copy the arguments
+  // into this object and execute the cached statement. The name should
+  // be unique among the queries cached on the connection and must remain
+  // valid while any connection caches the query (a string literal is
+  // normally used).
+  //
+  template <typename T, typename A>
+  class query_template
+  {
+  public:
+    typedef T object_type;
+    typedef A arguments_type;
+    typedef odb::query<T> query_type;
+    typedef query_type (*builder_type) (const A&);
+
+    query_template (const char* name, builder_type builder)
+        : name_ (name), builder_ (builder)
+    {
+    }
+
+    const char*
+    name () const
+    {
+      return name_;
+    }
+
+    // The following functions should be called within a transaction and
+    // have the same semantics as the corresponding prepared_query
+    // functions.
+    //
+    result<T>
+    execute (database& db, const A& args, bool cache = true) const
+    {
+      return prepare (db, args).execute (cache);
+    }
+
+    typename object_traits<T>::pointer_type
+    execute_one (database& db, const A& args) const
+    {
+      return prepare (db, args).execute_one ();
+    }
+
+    bool
+    execute_one (database& db, const A& args, T& object) const
+    {
+      return prepare (db, args).execute_one (object);
+    }
+
+    T
+    execute_value (database& db, const A& args) const
+    {
+      return prepare (db, args).execute_value ();
+    }
+
+    // Return the prepared query for the current transaction's connection
+    // with its parameters set to the specified arguments.
+    //
+    prepared_query<T>
+    prepare (database& db, const A& args) const
+    {
+      connection& c (transaction::current ().connection (db));
+
+      A* p (0);
+      prepared_query<T> pq (c.lookup_query<T, A> (name_, p));
+
+      if (pq)
+        *p = args;
+      else
+      {
+#ifdef ODB_CXX11
+        std::unique_ptr<A> a (new A (args));
+        pq = c.prepare_query<T> (name_, builder_ (*a));
+        c.cache_query (pq, std::move (a));
+#else
+        std::auto_ptr<A> a (new A (args));
+        pq = c.prepare_query<T> (name_, builder_ (*a));
+        c.cache_query (pq, a);
+#endif
+      }
+
+      return pq;
+    }
+
+  private:
+    const char* name_;
+    builder_type builder_;
+  };
+
+  namespace common
+  {
+    using odb::query_template;
+  }
+}
+
+#include <odb/post.hxx>
+
+#endif // ODB_QUERY_TEMPLATE_HXX
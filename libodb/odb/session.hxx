@@ -11,6 +11,7 @@
 
 #include <odb/traits.hxx>
 #include <odb/forward.hxx>
+#include <odb/snapshot-store.hxx>
 
 #include <odb/details/shared-ptr.hxx>
 #include <odb/details/type-info.hxx>
@@ -128,6 +129,12 @@ namespace odb
     const database_map&
     map () const {return db_map_;}
 
+    // Container and object snapshots (see odb/snapshot-store.hxx).
+    //
+  public:
+    snapshot_store&
+    snapshots () {return snapshots_;}
+
     // Static cache API as expected by the rest of ODB.
     //
   public:
@@ -206,6 +213,9 @@ namespace odb
 
   protected:
     database_map db_map_;
+
+  private:
+    snapshot_store snapshots_;
   };
 }
 
@@ -0,0 +1,138 @@
+// file      : odb/snapshot-container-traits.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SNAPSHOT_CONTAINER_TRAITS_HXX
+#define ODB_SNAPSHOT_CONTAINER_TRAITS_HXX
+
+#include <odb/pre.hxx>
+
+#include <cstddef> // std::size_t
+
+#include <odb/transaction.hxx>
+#include <odb/snapshot-store.hxx>
+#include <odb/container-traits.hxx>
+
+namespace odb
+{
+  // Container traits implementation that makes a standard ordered
+  // container (std::vector, std::deque, or std::list) smart without
+  // changing its type. When the container is loaded or persisted in a
+  // session, a copy of its elements is recorded in this session and on
+  // update only the elements that compare unequal to their copies are
+  // updated, new elements are inserted, and removed elements are
+  // deleted. Without a session (or if the database runtime cannot tell
+  // which object owns the container) the container is updated by
+  // deleting and re-inserting all the elements, as usual. The element
+  // type should be copyable and equality-comparable.
+  //
+  // To enable this mode for a container type, specialize container_traits
+  // for it before the persistent class definition, for example:
+  //
+  // namespace odb
+  // {
+  //   template <>
+  //   class access::container_traits<std::vector<std::string> >
+  //     : public snapshot_container_traits<std::vector<std::string> > {};
+  // }
+  //
+  template <typename C>
+  class snapshot_container_traits
+  {
+  public:
+    static const container_kind kind = ck_ordered;
+    static const bool smart = true;
+
+    typedef C container_type;
+
+    typedef typename C::value_type value_type;
+    typedef typename C::size_type index_type;
+
+    typedef smart_ordered_functions<index_type, value_type> functions;
+    typedef ordered_functions<index_type, value_type> dumb_functions;
+
+    typedef snapshot_store::container_snapshot<value_type> snapshot_type;
+
+  public:
+    static void
+    persist (const container_type& c, const functions& f)
+    {
+      index_type i (0);
+      for (typename C::const_iterator j (c.begin ()), e (c.end ());
+           j != e;
+           ++j)
+        f.insert (i++, *j);
+
+      snapshot (c, f, true);
+    }
+
+    static void
+    load (container_type& c, bool more, const functions& f)
+    {
+      c.clear ();
+
+      while (more)
+      {
+        index_type dummy;
+        c.push_back (value_type ());
+        more = f.select (dummy, c.back ());
+      }
+
+      snapshot (c, f, false);
+    }
+
+    // The container cannot tell which object it belongs to here and so
+    // cannot find its snapshot. As a result, it is always considered
+    // changed and update() determines what actually needs updating.
+    //
+    static bool
+    changed (const container_type&)
+    {
+      return true;
+    }
+
+    static void
+    update (const container_type&, const functions&);
+
+    static void
+    erase (const container_type* c, const functions& f)
+    {
+      f.delete_ (0);
+
+      if (c != 0)
+      {
+        if (snapshot_store* s = snapshot_store::current_pointer ())
+          s->container_erase (c);
+      }
+    }
+
+    // Version of load() for dumb functions. Used to support inverse
+    // members of the container type.
+    //
+    static void
+    load (container_type& c, bool more, const dumb_functions& f)
+    {
+      c.clear ();
+
+      while (more)
+      {
+        index_type dummy;
+        c.push_back (value_type ());
+        more = f.select (dummy, c.back ());
+      }
+    }
+
+  private:
+    // Record the snapshot of the container in the current session, if
+    // any. If armed is true, then discard it if the current transaction
+    // is rolled back.
+    //
+    static void
+    snapshot (const container_type&, const functions&, bool armed);
+  };
+}
+
+#include <odb/snapshot-container-traits.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SNAPSHOT_CONTAINER_TRAITS_HXX
@@ -0,0 +1,101 @@
+// file      : odb/snapshot-container-traits.txx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  template <typename C>
+  void snapshot_container_traits<C>::
+  update (const container_type& c, const functions& f)
+  {
+    snapshot_store* s (snapshot_store::current_pointer ());
+    snapshot_store::owner_key k;
+
+    if (s == 0 || !f.owner (k))
+    {
+      // Fall back to delete all/insert all.
+      //
+      f.delete_ (0);
+
+      index_type i (0);
+      for (typename C::const_iterator j (c.begin ()), e (c.end ());
+           j != e;
+           ++j)
+        f.insert (i++, *j);
+
+      return;
+    }
+
+    // If this object's container was neither loaded nor persisted in this
+    // session, then delete all the elements and start recording the
+    // snapshot.
+    //
+    if (s->container_find<value_type> (&c, k) == 0)
+      f.delete_ (0);
+
+    // Keep the snapshot in sync with the database as we go and discard it
+    // if anything fails. If the transaction is rolled back, then the
+    // snapshot will be discarded as well.
+    //
+    snapshot_type& p (
+      s->container_insert<value_type> (&c, k, &transaction::current ()));
+
+    try
+    {
+      std::size_t n (p.size ()), i (0);
+      typename C::const_iterator j (c.begin ()), e (c.end ());
+
+      for (; j != e && i != n; ++j, ++i)
+      {
+        if (!(*j == p[i]))
+        {
+          f.update (static_cast<index_type> (i), *j);
+          p[i] = *j;
+        }
+      }
+
+      if (i != n)
+      {
+        f.delete_ (static_cast<index_type> (i)); // Delete from i onwards.
+        p.resize (i);
+      }
+      else
+      {
+        for (; j != e; ++j, ++i)
+        {
+          f.insert (static_cast<index_type> (i), *j);
+          p.push_back (*j);
+        }
+      }
+    }
+    catch (...)
+    {
+      s->container_erase (&c);
+      throw;
+    }
+  }
+
+  template <typename C>
+  void snapshot_container_traits<C>::
+  snapshot (const container_type& c, const functions& f, bool armed)
+  {
+    snapshot_store* s (snapshot_store::current_pointer ());
+    snapshot_store::owner_key k;
+
+    if (s == 0 || !f.owner (k))
+      return;
+
+    snapshot_type& p (
+      s->container_insert<value_type> (
+        &c, k, armed ? &transaction::current () : 0));
+
+    try
+    {
+      p.assign (c.begin (), c.end ());
+    }
+    catch (...)
+    {
+      s->container_erase (&c);
+      throw;
+    }
+  }
+}
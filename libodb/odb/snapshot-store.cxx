@@ -0,0 +1,161 @@
+// file      : odb/snapshot-store.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <odb/details/config.hxx> // ODB_CXX11
+
+#include <odb/session.hxx>
+#include <odb/transaction.hxx>
+#include <odb/snapshot-store.hxx>
+
+#ifdef ODB_CXX11
+#  include <odb/hash-session.hxx>
+#endif
+
+namespace odb
+{
+  snapshot_store::
+  ~snapshot_store ()
+  {
+    // Unregister the callbacks since they refer to us.
+    //
+    for (armed_list::iterator i (armed_.begin ()); i != armed_.end (); ++i)
+    {
+      if (i->tran != 0)
+        i->tran->callback_unregister (&*i);
+    }
+  }
+
+  snapshot_store* snapshot_store::
+  current_pointer ()
+  {
+    if (session* s = session::current_pointer ())
+      return &s->snapshots ();
+
+#ifdef ODB_CXX11
+    if (hash_session* s = hash_session::current_pointer ())
+      return &s->snapshots ();
+#endif
+
+    return 0;
+  }
+
+  void snapshot_store::
+  container_erase (const void* c)
+  {
+    container_map::iterator i (container_map_.find (c));
+
+    if (i != container_map_.end ())
+    {
+      disarm (i->second);
+      container_map_.erase (i);
+    }
+  }
+
+  void snapshot_store::
+  arm (entry& e, transaction* t)
+  {
+    if (t == 0 || (e.set != 0 && e.set->tran == t))
+      return;
+
+    disarm (e);
+
+    // There is normally only one transaction at a time so we use linear
+    // search.
+    //
+    armed_list::iterator i (armed_.begin ());
+    for (; i != armed_.end () && i->tran != t; ++i) ;
+
+    if (i == armed_.end ())
+    {
+      i = armed_.insert (armed_.end (), armed_set ());
+      i->store = this;
+      i->tran = t;
+
+      try
+      {
+        t->callback_register (&callback,
+                              &*i,
+                              transaction::event_all,
+                              0,
+                              &i->tran);
+      }
+      catch (...)
+      {
+        armed_.erase (i);
+        throw;
+      }
+    }
+
+    armed_set& s (*i);
+    s.entries.push_back (&e);
+    e.set = &s;
+    e.index = s.entries.size () - 1;
+  }
+
+  void snapshot_store::
+  disarm (entry& e)
+  {
+    // Move the last entry into our position.
+    //
+    if (armed_set* s = e.set)
+    {
+      entry& l (*s->entries.back ());
+      s->entries[e.index] = &l;
+      l.index = e.index;
+      s->entries.pop_back ();
+      e.set = 0;
+    }
+  }
+
+  void snapshot_store::
+  callback (unsigned short event, void* key, unsigned long long)
+  {
+    armed_set& s (*static_cast<armed_set*> (key));
+    snapshot_store& ss (*s.store);
+
+    for (std::vector<entry*>::iterator i (s.entries.begin ());
+         i != s.entries.end ();
+         ++i)
+    {
+      entry& e (**i);
+      e.set = 0;
+
+      // The rolled back changes may have been recorded in the snapshot.
+      //
+      if (event == transaction::event_rollback)
+      {
+        if (e.container != 0)
+          ss.container_map_.erase (e.container);
+        else
+          static_cast<object_entry&> (e).snapshot.clear ();
+      }
+    }
+
+    for (armed_list::iterator i (ss.armed_.begin ());
+         i != ss.armed_.end ();
+         ++i)
+    {
+      if (&*i == &s)
+      {
+        ss.armed_.erase (i);
+        break;
+      }
+    }
+  }
+
+  //
+  // container_snapshot_base
+  //
+  snapshot_store::container_snapshot_base::
+  ~container_snapshot_base ()
+  {
+  }
+
+  //
+  // object_map_base
+  //
+  snapshot_store::object_map_base::
+  ~object_map_base ()
+  {
+  }
+}
@@ -0,0 +1,263 @@
+// file      : odb/snapshot-store.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_SNAPSHOT_STORE_HXX
+#define ODB_SNAPSHOT_STORE_HXX
+
+#include <odb/pre.hxx>
+
+#include <map>
+#include <list>
+#include <vector>
+#include <cstddef>  // std::size_t
+#include <cstring>  // std::memcmp
+#include <typeinfo>
+
+#include <odb/traits.hxx>
+#include <odb/forward.hxx> // database, transaction
+
+#include <odb/details/shared-ptr.hxx>
+#include <odb/details/type-info.hxx>
+
+#include <odb/details/export.hxx>
+
+namespace odb
+{
+  // Snapshots of the database state of containers and objects. Used by
+  // the snapshot container traits (see odb/snapshot-container-traits.hxx)
+  // and by the generated code for objects with dirty tracking (see the
+  // db dirty_tracking pragma) to only update what has changed. Each
+  // session (odb::session and odb::hash_session) has its own store.
+  //
+  // A snapshot can be armed for a transaction in which case it is
+  // discarded if this transaction is rolled back. The store registers a
+  // single callback with each such transaction rather than one for each
+  // snapshot.
+  //
+  class LIBODB_EXPORT snapshot_store
+  {
+  public:
+    typedef odb::database database_type;
+
+    snapshot_store () {}
+    ~snapshot_store ();
+
+    // Return the snapshot store of the current session (odb::session or,
+    // in C++11, odb::hash_session) or NULL if there is no session in
+    // effect. Note that custom sessions do not have snapshot stores.
+    //
+    static snapshot_store*
+    current_pointer ();
+
+    // Container snapshots. The snapshot contains a copy of each element
+    // and is identified by the container address. It also records the
+    // key of the object that owns the container (see
+    // smart_ordered_functions::owner()) so that the snapshot of a
+    // destroyed object is not used for another object that was created
+    // at the same address.
+    //
+  public:
+    typedef std::vector<char> owner_key;
+
+    struct container_snapshot_base: details::shared_base
+    {
+      virtual
+      ~container_snapshot_base ();
+    };
+
+    template <typename V>
+    struct container_snapshot: container_snapshot_base, std::vector<V>
+    {
+    };
+
+    // Return NULL if there is no snapshot for this container or if it
+    // belongs to a different object.
+    //
+    template <typename V>
+    container_snapshot<V>*
+    container_find (const void* container, const owner_key&);
+
+    // Return the existing snapshot or insert an empty one. If the
+    // existing snapshot belongs to a different object, then replace it
+    // with an empty one. If the transaction is not NULL, then discard
+    // the snapshot if this transaction is rolled back.
+    //
+    template <typename V>
+    container_snapshot<V>&
+    container_insert (const void* container, const owner_key&, transaction*);
+
+    void
+    container_erase (const void* container);
+
+    // Object snapshots. The snapshot contains a copy of each column value
+    // (in a database-specific representation) and is identified by the
+    // object id. A rolled back snapshot is cleared rather than erased.
+    //
+  public:
+    class object_snapshot
+    {
+    public:
+      // Number of columns.
+      //
+      std::size_t
+      size () const {return ends_.size ();}
+
+      bool
+      empty () const {return ends_.empty ();}
+
+      void
+      clear ()
+      {
+        data_.clear ();
+        ends_.clear ();
+      }
+
+      void
+      swap (object_snapshot& x)
+      {
+        data_.swap (x.data_);
+        ends_.swap (x.ends_);
+      }
+
+      // Append the data to the last column value. Call end_column() to
+      // start the next column.
+      //
+      void
+      append (const void* d, std::size_t n)
+      {
+        const char* p (static_cast<const char*> (d));
+        data_.insert (data_.end (), p, p + n);
+      }
+
+      void
+      end_column () {ends_.push_back (data_.size ());}
+
+      // Return true if the values of the column are the same in both
+      // snapshots.
+      //
+      bool
+      equal (std::size_t c, const object_snapshot& x) const
+      {
+        std::size_t b (c != 0 ? ends_[c - 1] : 0), n (ends_[c] - b);
+        std::size_t xb (c != 0 ? x.ends_[c - 1] : 0), xn (x.ends_[c] - xb);
+
+        return n == xn &&
+          (n == 0 || std::memcmp (&data_[b], &x.data_[xb], n) == 0);
+      }
+
+    private:
+      std::vector<char> data_;
+      std::vector<std::size_t> ends_; // End of each column value in data_.
+    };
+
+    // Return NULL if there is no snapshot for this object or if it has
+    // been discarded.
+    //
+    template <typename T>
+    object_snapshot*
+    object_find (database_type&, const typename object_traits<T>::id_type&);
+
+    // Return the existing snapshot or insert an empty one. If the
+    // transaction is not NULL, then discard the snapshot if this
+    // transaction is rolled back.
+    //
+    template <typename T>
+    object_snapshot&
+    object_insert (database_type&,
+                   const typename object_traits<T>::id_type&,
+                   transaction*);
+
+    template <typename T>
+    void
+    object_erase (database_type&, const typename object_traits<T>::id_type&);
+
+  private:
+    snapshot_store (const snapshot_store&);
+    snapshot_store& operator= (const snapshot_store&);
+
+  private:
+    struct armed_set;
+
+    struct entry
+    {
+      entry (const void* c = 0): container (c), set (0), index (0) {}
+
+      const void* container; // NULL for object snapshots.
+      armed_set* set;        // Set we are armed in, if any.
+      std::size_t index;     // Position in set->entries.
+    };
+
+    struct container_entry: entry
+    {
+      container_entry (const void* c): entry (c) {}
+
+      owner_key owner;
+      details::shared_ptr<container_snapshot_base> snapshot;
+    };
+
+    struct object_entry: entry
+    {
+      object_snapshot snapshot;
+    };
+
+    // Snapshots armed for a transaction. The transaction resets tran to
+    // NULL when it terminates.
+    //
+    struct armed_set
+    {
+      snapshot_store* store;
+      transaction* tran;
+      std::vector<entry*> entries;
+    };
+
+    typedef std::list<armed_set> armed_list;
+
+    void
+    arm (entry&, transaction*);
+
+    static void
+    disarm (entry&);
+
+    static void
+    callback (unsigned short, void*, unsigned long long);
+
+  private:
+    typedef std::map<const void*, container_entry> container_map;
+
+    struct object_map_base: details::shared_base
+    {
+      virtual
+      ~object_map_base ();
+    };
+
+    // Object snapshots are stored per database and type, similar to the
+    // object cache in odb::session.
+    //
+    template <typename T>
+    struct object_map: object_map_base,
+                       std::map<typename object_traits<T>::id_type,
+                                object_entry>
+    {
+    };
+
+    typedef std::map<const std::type_info*,
+                     details::shared_ptr<object_map_base>,
+                     details::type_info_comparator> type_map;
+
+    typedef std::map<database_type*, type_map> database_map;
+
+    template <typename T>
+    object_map<T>*
+    find_map (database_type&);
+
+    container_map container_map_;
+    database_map object_map_;
+    armed_list armed_;
+  };
+}
+
+#include <odb/snapshot-store.txx>
+
+#include <odb/post.hxx>
+
+#endif // ODB_SNAPSHOT_STORE_HXX
@@ -0,0 +1,118 @@
+// file      : odb/snapshot-store.txx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+namespace odb
+{
+  template <typename V>
+  snapshot_store::container_snapshot<V>* snapshot_store::
+  container_find (const void* c, const owner_key& o)
+  {
+    container_map::iterator i (container_map_.find (c));
+
+    return i != container_map_.end () && i->second.owner == o
+      ? &static_cast<container_snapshot<V>&> (*i->second.snapshot)
+      : 0;
+  }
+
+  template <typename V>
+  snapshot_store::container_snapshot<V>& snapshot_store::
+  container_insert (const void* c, const owner_key& o, transaction* t)
+  {
+    container_map::iterator i (container_map_.find (c));
+
+    if (i == container_map_.end ())
+      i = container_map_.insert (
+        container_map::value_type (c, container_entry (c))).first;
+
+    container_entry& e (i->second);
+
+    // The snapshot may have been left by the container of another object
+    // that used to be at this address.
+    //
+    if (!e.snapshot || e.owner != o)
+    {
+      details::shared_ptr<container_snapshot_base> p (
+        new (details::shared) container_snapshot<V>);
+
+      owner_key k (o);
+      e.owner.swap (k);
+      e.snapshot = p;
+    }
+
+    arm (e, t);
+    return static_cast<container_snapshot<V>&> (*e.snapshot);
+  }
+
+  template <typename T>
+  snapshot_store::object_map<T>* snapshot_store::
+  find_map (database_type& db)
+  {
+    database_map::iterator di (object_map_.find (&db));
+
+    if (di == object_map_.end ())
+      return 0;
+
+    type_map& tm (di->second);
+    type_map::iterator ti (tm.find (&typeid (T)));
+
+    if (ti == tm.end ())
+      return 0;
+
+    return &static_cast<object_map<T>&> (*ti->second);
+  }
+
+  template <typename T>
+  typename snapshot_store::object_snapshot* snapshot_store::
+  object_find (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    object_map<T>* m (find_map<T> (db));
+
+    if (m == 0)
+      return 0;
+
+    typename object_map<T>::iterator i (m->find (id));
+
+    // An empty snapshot was discarded on rollback.
+    //
+    return i != m->end () && !i->second.snapshot.empty ()
+      ? &i->second.snapshot
+      : 0;
+  }
+
+  template <typename T>
+  typename snapshot_store::object_snapshot& snapshot_store::
+  object_insert (database_type& db,
+                 const typename object_traits<T>::id_type& id,
+                 transaction* t)
+  {
+    type_map& tm (object_map_[&db]);
+    details::shared_ptr<object_map_base>& pm (tm[&typeid (T)]);
+
+    if (!pm)
+      pm.reset (new (details::shared) object_map<T>);
+
+    object_map<T>& m (static_cast<object_map<T>&> (*pm));
+
+    object_entry& e (m[id]);
+    arm (e, t);
+    return e.snapshot;
+  }
+
+  template <typename T>
+  void snapshot_store::
+  object_erase (database_type& db, const typename object_traits<T>::id_type& id)
+  {
+    object_map<T>* m (find_map<T> (db));
+
+    if (m == 0)
+      return;
+
+    typename object_map<T>::iterator i (m->find (id));
+
+    if (i != m->end ())
+    {
+      disarm (i->second);
+      m->erase (i);
+    }
+  }
+}
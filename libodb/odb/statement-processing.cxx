@@ -533,11 +533,13 @@ namespace odb
       size_t i (0), bi (0);
 
       for (const char *c (columns_begin), *ce (comma_begin (c, e));
-           ce != 0; comma_next (c, ce, e))
+           ce != 0; comma_next (c, ce, e), ++bi)
       {
-        // See if the column is present in the bind array.
+        // See if the column is present in the bind array. Columns past
+        // the end of the bind array (for example, extra columns that are
+        // loaded with a different binding) are always present.
         //
-        if (bind_at (bi++, bind, bind_skip) == 0)
+        if (bi < bind_size && bind_at (bi, bind, bind_skip) == 0)
           continue;
 
         // Append the column.
@@ -0,0 +1,249 @@
+// file      : odb/statistics-tracer.cxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#include <new>       // std::bad_alloc
+#include <ostream>
+#include <algorithm> // std::sort
+
+#include <odb/statement.hxx>
+#include <odb/statistics-tracer.hxx>
+
+#include <odb/details/lock.hxx>
+
+using namespace std;
+
+namespace odb
+{
+  using details::lock;
+
+  //
+  // statistics_tracer
+  //
+
+  statistics_tracer::statement_stats::
+  statement_stats ()
+      : prepares (0),
+        executions (0),
+        duration (0),
+        max_duration (0),
+        rows_fetched (0),
+        rows_affected (0),
+        lock_waits (0),
+        busy (0)
+  {
+    for (size_t i (0); i != histogram_size; ++i)
+      histogram[i] = 0;
+  }
+
+  statistics_tracer::stats_map statistics_tracer::
+  stats () const
+  {
+    lock l (mutex_);
+    return map_;
+  }
+
+  void statistics_tracer::
+  reset ()
+  {
+    lock l (mutex_);
+    map_.clear ();
+  }
+
+  void statistics_tracer::
+  prepare (connection&, const statement& s)
+  {
+    // The statistics are best-effort so drop the sample rather than fail
+    // the statement if we run out of memory.
+    //
+    try
+    {
+      lock l (mutex_);
+      map_[s.text ()].prepares++;
+    }
+    catch (const bad_alloc&)
+    {
+    }
+  }
+
+  void statistics_tracer::
+  execute (connection&, const statement&)
+  {
+    // Counted in executed().
+  }
+
+  void statistics_tracer::
+  execute (connection&, const char*)
+  {
+  }
+
+  void statistics_tracer::
+  executed (connection&, const statement& s, const execution_stats& x)
+  {
+    // Histogram bucket: 0 for less than 1us and 1 + log2(us) otherwise.
+    //
+    size_t b (0);
+    for (unsigned long long us (x.duration / 1000);
+         us != 0 && b != histogram_size - 1;
+         us >>= 1)
+      b++;
+
+    try
+    {
+      lock l (mutex_);
+      statement_stats& ss (map_[s.text ()]);
+
+      ss.executions++;
+      ss.duration += x.duration;
+
+      if (x.duration > ss.max_duration)
+        ss.max_duration = x.duration;
+
+      ss.rows_fetched += x.rows_fetched;
+      ss.rows_affected += x.rows_affected;
+      ss.lock_waits += x.lock_waits;
+      ss.busy += x.busy;
+      ss.histogram[b]++;
+    }
+    catch (const bad_alloc&)
+    {
+    }
+  }
+
+  typedef pair<string, statistics_tracer::statement_stats> stats_entry;
+
+  static bool
+  hotter (const stats_entry& x, const stats_entry& y)
+  {
+    return x.second.duration != y.second.duration
+      ? x.second.duration > y.second.duration
+      : x.second.executions > y.second.executions;
+  }
+
+  statistics_tracer::sorted_stats statistics_tracer::
+  sort (size_t limit) const
+  {
+    sorted_stats r;
+    {
+      lock l (mutex_);
+      r.assign (map_.begin (), map_.end ());
+    }
+
+    std::sort (r.begin (), r.end (), &hotter);
+
+    if (limit != 0 && r.size () > limit)
+      r.resize (limit);
+
+    return r;
+  }
+
+  void statistics_tracer::
+  print (ostream& os, size_t limit) const
+  {
+    sorted_stats ss (sort (limit));
+
+    for (sorted_stats::const_iterator i (ss.begin ()); i != ss.end (); ++i)
+    {
+      const statement_stats& s (i->second);
+
+      if (i != ss.begin ())
+        os << endl;
+
+      os << i->first << endl
+         << "  executions: " << s.executions
+         << ", prepares: " << s.prepares << endl
+         << "  time: " << s.duration / 1000 << "us total, "
+         << (s.executions != 0 ? s.duration / s.executions / 1000 : 0)
+         << "us average, " << s.max_duration / 1000 << "us max" << endl
+         << "  rows: " << s.rows_fetched << " fetched, "
+         << s.rows_affected << " affected" << endl
+         << "  waits: " << s.lock_waits << " lock, " << s.busy << " busy"
+         << endl;
+
+      // Only print the non-empty buckets.
+      //
+      os << "  latency:";
+
+      for (size_t b (0); b != histogram_size; ++b)
+      {
+        if (s.histogram[b] == 0)
+          continue;
+
+        if (b == 0)
+          os << " <1us";
+        else if (b != histogram_size - 1)
+          os << " <" << (1ULL << b) << "us";
+        else
+          os << " >=" << (1ULL << (b - 1)) << "us";
+
+        os << ": " << s.histogram[b];
+      }
+
+      os << endl;
+    }
+  }
+
+  static void
+  print_json_string (ostream& os, const string& s)
+  {
+    static const char hex[] = "0123456789abcdef";
+
+    os << '"';
+
+    for (string::const_iterator i (s.begin ()); i != s.end (); ++i)
+    {
+      unsigned char c (static_cast<unsigned char> (*i));
+
+      switch (c)
+      {
+      case '"':  os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        {
+          if (c < 0x20)
+            os << "\\u00" << hex[c >> 4] << hex[c & 0x0F];
+          else
+            os << *i;
+        }
+      }
+    }
+
+    os << '"';
+  }
+
+  void statistics_tracer::
+  print_json (ostream& os, size_t limit) const
+  {
+    sorted_stats ss (sort (limit));
+
+    os << '[';
+
+    for (sorted_stats::const_iterator i (ss.begin ()); i != ss.end (); ++i)
+    {
+      const statement_stats& s (i->second);
+
+      os << (i != ss.begin () ? "," : "") << endl
+         << "  {\"statement\": ";
+      print_json_string (os, i->first);
+
+      os << ", \"prepares\": " << s.prepares
+         << ", \"executions\": " << s.executions
+         << ", \"duration_ns\": " << s.duration
+         << ", \"max_duration_ns\": " << s.max_duration
+         << ", \"rows_fetched\": " << s.rows_fetched
+         << ", \"rows_affected\": " << s.rows_affected
+         << ", \"lock_waits\": " << s.lock_waits
+         << ", \"busy\": " << s.busy
+         << ", \"histogram\": [";
+
+      for (size_t b (0); b != histogram_size; ++b)
+        os << (b != 0 ? ", " : "") << s.histogram[b];
+
+      os << "]}";
+    }
+
+    os << (ss.empty () ? "" : "\n") << ']' << endl;
+  }
+}
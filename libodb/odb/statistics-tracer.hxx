@@ -0,0 +1,113 @@
+// file      : odb/statistics-tracer.hxx
+// license   : GNU GPL v2; see accompanying LICENSE file
+
+#ifndef ODB_STATISTICS_TRACER_HXX
+#define ODB_STATISTICS_TRACER_HXX
+
+#include <odb/pre.hxx>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility> // std::pair
+#include <cstddef> // std::size_t
+#include <iosfwd>
+
+#include <odb/tracer.hxx>
+#include <odb/forward.hxx>
+
+#include <odb/details/mutex.hxx>
+#include <odb/details/export.hxx>
+
+namespace odb
+{
+  // Tracer that aggregates the execution statistics (see
+  // tracer::executed()) per statement text. It can be installed on the
+  // database, connection, or transaction the same as any other tracer
+  // and is thread-safe so a single instance can be shared by all the
+  // connections of a database.
+  //
+  // Statements executed directly as text (for example, with
+  // database::execute()) are not prepared by all the database runtimes
+  // and are only counted if they are.
+  //
+  class LIBODB_EXPORT statistics_tracer: public tracer
+  {
+  public:
+    // The latency histogram has a bucket for executions that took less
+    // than 1us followed by buckets for [2^(i-1), 2^i) microseconds. The
+    // last bucket also counts all the longer executions.
+    //
+    static const std::size_t histogram_size = 24;
+
+    struct statement_stats
+    {
+      statement_stats ();
+
+      unsigned long long prepares;
+      unsigned long long executions;
+      unsigned long long duration;     // Total, in nanoseconds.
+      unsigned long long max_duration; // In nanoseconds.
+      unsigned long long rows_fetched;
+      unsigned long long rows_affected;
+      unsigned long long lock_waits;
+      unsigned long long busy;
+      unsigned long long histogram[histogram_size];
+    };
+
+    typedef std::map<std::string, statement_stats> stats_map;
+
+    statistics_tracer () {}
+
+    // Return a copy of the statistics collected so far.
+    //
+    stats_map
+    stats () const;
+
+    void
+    reset ();
+
+    // Print the statistics ordered by the total execution time, the
+    // hottest statements first. If limit is not 0, then only print that
+    // many statements.
+    //
+    void
+    print (std::ostream&, std::size_t limit = 0) const;
+
+    void
+    print_json (std::ostream&, std::size_t limit = 0) const;
+
+    // Tracer interface.
+    //
+  public:
+    virtual void
+    prepare (connection&, const statement&);
+
+    virtual void
+    execute (connection&, const statement&);
+
+    virtual void
+    execute (connection&, const char* statement);
+
+    virtual void
+    executed (connection&, const statement&, const execution_stats&);
+
+  private:
+    statistics_tracer (const statistics_tracer&);
+    statistics_tracer& operator= (const statistics_tracer&);
+
+    typedef std::vector<std::pair<std::string, statement_stats> >
+    sorted_stats;
+
+    sorted_stats
+    sort (std::size_t limit) const;
+
+  private:
+    mutable details::mutex mutex_;
+    stats_map map_;
+  };
+}
+
+#include <odb/post.hxx>
+
+#endif // ODB_STATISTICS_TRACER_HXX
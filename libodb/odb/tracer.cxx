@@ -35,6 +35,11 @@ namespace odb
   {
   }
 
+  void tracer::
+  executed (connection&, const statement&, const execution_stats&)
+  {
+  }
+
   //
   // stderr_tracer
   //
@@ -28,6 +28,26 @@ namespace odb
 
     virtual void
     deallocate (connection&, const statement&);
+
+    // Statement execution statistics. The executed() function is called
+    // once the statement execution is complete which, for queries, is when
+    // the result has been exhausted or freed. The duration is the time
+    // spent in the database (in nanoseconds) and may be zero if the
+    // database runtime cannot measure it. Lock waits is the number of
+    // times the execution had to wait for another connection to release
+    // a lock and busy is the number of times the database was busy.
+    //
+    struct execution_stats
+    {
+      unsigned long long duration;
+      unsigned long long rows_fetched;
+      unsigned long long rows_affected;
+      unsigned long long lock_waits;
+      unsigned long long busy;
+    };
+
+    virtual void
+    executed (connection&, const statement&, const execution_stats&);
   };
 }
 
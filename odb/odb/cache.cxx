@@ -0,0 +1,451 @@
+// file      : odb/cache.cxx
+// license   : GNU GPL v3; see accompanying LICENSE file
+
+#include <errno.h>
+#include <stdio.h>     // rename, remove
+#include <string.h>    // strerror
+#include <sys/types.h> // mkdir
+#include <sys/stat.h>  // mkdir
+
+#ifndef _WIN32
+#  include <unistd.h>  // getpid
+#else
+#  include <direct.h>  // _mkdir
+#  include <process.h> // _getpid
+#endif
+
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+
+#include <odb/cache.hxx>
+
+using namespace std;
+using cutl::fs::path;
+
+//
+// sha1
+//
+
+static inline uint32_t
+rol (uint32_t x, unsigned int n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+sha1::
+sha1 ()
+    : n_ (0), size_ (0), done_ (false)
+{
+  h_[0] = 0x67452301;
+  h_[1] = 0xEFCDAB89;
+  h_[2] = 0x98BADCFE;
+  h_[3] = 0x10325476;
+  h_[4] = 0xC3D2E1F0;
+}
+
+void sha1::
+append (void const* d, size_t n)
+{
+  unsigned char const* p (static_cast<unsigned char const*> (d));
+  size_ += n;
+
+  while (n != 0)
+  {
+    size_t m (64 - n_ < n ? 64 - n_ : n);
+    memcpy (buf_ + n_, p, m);
+
+    p += m;
+    n -= m;
+
+    if ((n_ += m) == 64)
+    {
+      block (buf_);
+      n_ = 0;
+    }
+  }
+}
+
+void sha1::
+append (std::string const& s)
+{
+  append (s.c_str (), s.size () + 1);
+}
+
+std::string sha1::
+string ()
+{
+  if (!done_)
+  {
+    unsigned long long bits (size_ * 8);
+
+    unsigned char c (0x80);
+    append (&c, 1);
+
+    for (c = 0; n_ != 56; )
+      append (&c, 1);
+
+    unsigned char l[8];
+    for (size_t i (0); i != 8; ++i)
+      l[i] = static_cast<unsigned char> (bits >> (56 - 8 * i));
+
+    append (l, 8);
+    done_ = true;
+  }
+
+  static char const hex[] = "0123456789abcdef";
+
+  std::string r;
+  for (size_t i (0); i != 5; ++i)
+  {
+    for (unsigned int s (32); s != 0; s -= 4)
+      r += hex[(h_[i] >> (s - 4)) & 0x0F];
+  }
+
+  return r;
+}
+
+void sha1::
+block (unsigned char const* p)
+{
+  uint32_t w[80];
+
+  for (size_t i (0); i != 16; ++i, p += 4)
+    w[i] = (uint32_t (p[0]) << 24) | (uint32_t (p[1]) << 16) |
+      (uint32_t (p[2]) << 8) | uint32_t (p[3]);
+
+  for (size_t i (16); i != 80; ++i)
+    w[i] = rol (w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+  uint32_t a (h_[0]), b (h_[1]), c (h_[2]), d (h_[3]), e (h_[4]);
+
+  for (size_t i (0); i != 80; ++i)
+  {
+    uint32_t f, k;
+
+    if (i < 20)
+    {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999;
+    }
+    else if (i < 40)
+    {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    }
+    else if (i < 60)
+    {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDC;
+    }
+    else
+    {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+
+    uint32_t t (rol (a, 5) + f + e + k + w[i]);
+    e = d;
+    d = c;
+    c = rol (b, 30);
+    b = a;
+    a = t;
+  }
+
+  h_[0] += a;
+  h_[1] += b;
+  h_[2] += c;
+  h_[3] += d;
+  h_[4] += e;
+}
+
+string
+file_checksum (path const& p)
+{
+  ifstream ifs (p.string ().c_str (), ios_base::in | ios_base::binary);
+
+  if (!ifs.is_open ())
+    return "-";
+
+  sha1 cs;
+  char buf[8192];
+
+  while (ifs.read (buf, sizeof (buf)) || ifs.gcount () != 0)
+    cs.append (buf, static_cast<size_t> (ifs.gcount ()));
+
+  return cs.string ();
+}
+
+//
+// Cache entries.
+//
+// An entry is a single file named after its key. It starts with a header
+// that lists the additional inputs with their checksums, the output files
+// with their sizes, and the sizes of the plugin's stdout and stderr. The
+// header is terminated with an empty line and is followed by the contents
+// of the output files, stdout, and stderr in this order. For example:
+//
+// odb-cache 1
+// input - person.xml
+// output 4096 person-odb.hxx
+// output 1024 person-odb.ixx
+// output 65536 person-odb.cxx
+// stdout 0
+// stderr 0
+//
+// The entry is first written to a temporary file that is then renamed so
+// that concurrent invocations never see a partially written entry.
+//
+
+static char const cache_header[] = "odb-cache 1";
+
+static bool
+read_size (istream& is, size_t& r)
+{
+  unsigned long long n;
+
+  if (!(is >> n))
+    return false;
+
+  r = static_cast<size_t> (n);
+  return true;
+}
+
+bool
+cache_restore (path const& dir,
+               string const& key,
+               string& out,
+               string& err,
+               char const* name)
+{
+  path ep (dir / path (key));
+  ifstream ifs (ep.string ().c_str (), ios_base::in | ios_base::binary);
+
+  if (!ifs.is_open ())
+    return false;
+
+  string l;
+  if (!getline (ifs, l) || l != cache_header)
+    return false;
+
+  // Parse the header checking the additional inputs as we go. Treat an
+  // entry that we cannot parse as absent.
+  //
+  vector<pair<path, size_t> > outs;
+  size_t out_size (0), err_size (0);
+
+  try
+  {
+    while (getline (ifs, l) && !l.empty ())
+    {
+      istringstream is (l);
+      string k;
+      is >> k;
+
+      if (k == "input")
+      {
+        string cs, p;
+        if (!(is >> cs && is.get () == ' ' && getline (is, p)))
+          return false;
+
+        if (file_checksum (path (p)) != cs)
+          return false;
+      }
+      else if (k == "output")
+      {
+        size_t n;
+        string p;
+        if (!(read_size (is, n) && is.get () == ' ' && getline (is, p)))
+          return false;
+
+        outs.push_back (make_pair (path (p), n));
+      }
+      else if (k == "stdout")
+      {
+        if (!read_size (is, out_size))
+          return false;
+      }
+      else if (k == "stderr")
+      {
+        if (!read_size (is, err_size))
+          return false;
+      }
+      else
+        return false;
+    }
+  }
+  catch (cutl::fs::invalid_path const&)
+  {
+    return false;
+  }
+
+  if (!ifs)
+    return false;
+
+  // Read the contents of all the output files before writing any of them
+  // in case the entry is truncated.
+  //
+  vector<string> data (outs.size () + 2);
+
+  for (size_t i (0); i != data.size (); ++i)
+  {
+    size_t n (i < outs.size ()
+              ? outs[i].second
+              : i == outs.size () ? out_size : err_size);
+    string& d (data[i]);
+
+    d.resize (n);
+    if (n != 0 && !ifs.read (&d[0], static_cast<streamsize> (n)))
+      return false;
+  }
+
+  for (size_t i (0); i != outs.size (); ++i)
+  {
+    path const& p (outs[i].first);
+    ofstream ofs (p.string ().c_str (),
+                  ios_base::out | ios_base::trunc | ios_base::binary);
+
+    if (!ofs.is_open ())
+    {
+      cerr << name << ": error: unable to open '" << p << "' in write mode"
+           << endl;
+      throw cache_failure ();
+    }
+
+    if (!ofs.write (data[i].c_str (),
+                    static_cast<streamsize> (data[i].size ())).flush ())
+    {
+      cerr << name << ": error: unable to write to '" << p << "'" << endl;
+      throw cache_failure ();
+    }
+  }
+
+  out.swap (data[outs.size ()]);
+  err.swap (data[outs.size () + 1]);
+  return true;
+}
+
+void
+cache_store (path const& dir,
+             string const& key,
+             string const& out,
+             string const& err,
+             char const* name)
+{
+  // Parse the plugin's stdout.
+  //
+  vector<string> ins;
+  vector<path> outs;
+
+  try
+  {
+    for (size_t b (0), e; b < out.size (); b = e + 1)
+    {
+      if ((e = out.find ('\n', b)) == string::npos)
+        e = out.size ();
+
+      string l (out, b, e - b);
+
+      if (l.compare (0, 10, "odb:input:") == 0)
+        ins.push_back (string (l, 10, string::npos));
+      else if (l.compare (0, 11, "odb:output:") == 0)
+        outs.push_back (path (string (l, 11, string::npos)));
+    }
+  }
+  catch (cutl::fs::invalid_path const& ex)
+  {
+    cerr << name << ": warning: unable to cache invalid path '"
+         << ex.path () << "'" << endl;
+    return;
+  }
+
+  // Create the cache directory if it doesn't exist. If this fails, then
+  // so will opening the temporary file below.
+  //
+  {
+#ifndef _WIN32
+    mkdir (dir.string ().c_str (), 0777);
+#else
+    _mkdir (dir.string ().c_str ());
+#endif
+  }
+
+  path ep (dir / path (key));
+  path tp (ep);
+  {
+    ostringstream os;
+#ifndef _WIN32
+    os << ".tmp." << getpid ();
+#else
+    os << ".tmp." << _getpid ();
+#endif
+    tp += os.str ();
+  }
+
+  {
+    ofstream ofs (tp.string ().c_str (),
+                  ios_base::out | ios_base::trunc | ios_base::binary);
+
+    if (!ofs.is_open ())
+    {
+      cerr << name << ": warning: unable to open '" << tp << "' in write "
+           << "mode" << endl;
+      return;
+    }
+
+    vector<string> data (outs.size ());
+
+    for (size_t i (0); i != outs.size (); ++i)
+    {
+      ifstream ifs (outs[i].string ().c_str (),
+                    ios_base::in | ios_base::binary);
+
+      ostringstream os;
+      if (!ifs.is_open () || !(os << ifs.rdbuf ()))
+      {
+        cerr << name << ": warning: unable to cache '" << outs[i] << "'"
+             << endl;
+        ofs.close ();
+        remove (tp.string ().c_str ());
+        return;
+      }
+
+      data[i] = os.str ();
+    }
+
+    ofs << cache_header << '\n';
+
+    for (size_t i (0); i != ins.size (); ++i)
+      ofs << "input " << ins[i] << '\n';
+
+    for (size_t i (0); i != outs.size (); ++i)
+      ofs << "output " << data[i].size () << ' ' << outs[i].string () << '\n';
+
+    ofs << "stdout " << out.size () << '\n'
+        << "stderr " << err.size () << '\n'
+        << '\n';
+
+    for (size_t i (0); i != data.size (); ++i)
+      ofs.write (data[i].c_str (), static_cast<streamsize> (data[i].size ()));
+
+    ofs.write (out.c_str (), static_cast<streamsize> (out.size ()));
+    ofs.write (err.c_str (), static_cast<streamsize> (err.size ()));
+
+    if (!ofs.flush ())
+    {
+      cerr << name << ": warning: unable to write to '" << tp << "'" << endl;
+      ofs.close ();
+      remove (tp.string ().c_str ());
+      return;
+    }
+  }
+
+  if (rename (tp.string ().c_str (), ep.string ().c_str ()) != 0)
+  {
+    char const* err (strerror (errno));
+    cerr << name << ": warning: unable to rename '" << tp << "' to '" << ep
+         << "': " << err << endl;
+    remove (tp.string ().c_str ());
+  }
+}
@@ -0,0 +1,95 @@
+// file      : odb/cache.hxx
+// license   : GNU GPL v3; see accompanying LICENSE file
+
+#ifndef ODB_CACHE_HXX
+#define ODB_CACHE_HXX
+
+#include <string>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+
+#include <libcutl/fs/path.hxx>
+
+// Content-hash cache of the generated files (--cache-dir).
+//
+// The driver keys each cache entry with the checksum of the preprocessed
+// translation unit, the plugin command line, and the ODB compiler and
+// host GCC versions.
+// While generating the code the plugin reports any additional files that
+// it reads (changelog, SQL prologues, etc) as odb:input:<checksum> <path>
+// lines and every file that it writes as odb:output:<path> lines on its
+// stdout. These are recorded in the entry together with the contents of
+// the output files and the plugin's stdout and stderr, so that restoring
+// an entry also reproduces the diagnostics.
+//
+
+// SHA-1 message digest.
+//
+class sha1
+{
+public:
+  sha1 ();
+
+  void
+  append (void const*, std::size_t);
+
+  // Append the string including the terminating '\0' so that a sequence
+  // of strings cannot produce the same digest as a different sequence
+  // with the same concatenation.
+  //
+  void
+  append (std::string const&);
+
+  // Return the digest as a hex string. No more data can be appended after
+  // this call.
+  //
+  std::string
+  string ();
+
+private:
+  void
+  block (unsigned char const*);
+
+private:
+  std::uint32_t h_[5];
+  unsigned char buf_[64];
+  std::size_t n_;           // Number of bytes in buf_.
+  unsigned long long size_; // Total number of bytes appended.
+  bool done_;
+};
+
+// Return the checksum of the file contents or "-" if the file does not
+// exist.
+//
+std::string
+file_checksum (cutl::fs::path const&);
+
+struct cache_failure {};
+
+// Try to restore the generated files from the entry with the specified
+// key. Return true and set out and err to the plugin's stdout and stderr
+// recorded in the entry if it exists and none of its additional inputs
+// have changed. Issue diagnostics and throw cache_failure if unable to
+// write an output file. The name argument is the program name for
+// diagnostics.
+//
+bool
+cache_restore (cutl::fs::path const& dir,
+               std::string const& key,
+               std::string& out,
+               std::string& err,
+               char const* name);
+
+// Create the entry with the specified key from the plugin's stdout and
+// stderr. The output files listed in stdout must still be present. Since
+// caching is just an optimization, issue a warning rather than failing if
+// anything goes wrong.
+//
+void
+cache_store (cutl::fs::path const& dir,
+             std::string const& key,
+             std::string const& out,
+             std::string const& err,
+             char const* name);
+
+#endif // ODB_CACHE_HXX
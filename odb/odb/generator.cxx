@@ -23,6 +23,7 @@
 #include <libcutl/xml/serializer.hxx>
 #endif
 
+#include <odb/cache.hxx>
 #include <odb/version.hxx>
 #include <odb/context.hxx>
 #include <odb/generator.hxx>
@@ -51,6 +52,19 @@ namespace
     "// compiler for C++.\n"
     "//\n\n";
 
+  // If true, then report the additional files that we read and the files
+  // that we write to the driver for caching (see cache.hxx for details).
+  //
+  bool report_files;
+  paths output_files;
+
+  void
+  report_input (path const& p)
+  {
+    if (report_files)
+      cout << "odb:input:" << file_checksum (p) << ' ' << p.string () << endl;
+  }
+
   static char const sql_file_header[] =
     "/* This file was generated by ODB, object-relational mapping (ORM)\n"
     " * compiler for C++.\n"
@@ -78,6 +92,9 @@ namespace
       cerr << "error: unable to open '" << p << "' in write mode" << endl;
       throw generator_failed ();
     }
+
+    if (report_files)
+      output_files.push_back (p);
   }
 
   void
@@ -93,6 +110,8 @@ namespace
   void
   append (ostream& os, path const& file)
   {
+    report_input (file);
+
     ifstream ifs;
     open (ifs, file);
 
@@ -162,6 +181,9 @@ generate (options const& ops,
     database db (ops.database ()[0]);
     multi_database md (ops.multi_database ());
 
+    report_files = ops.cache_dir_specified ();
+    output_files.clear ();
+
     // First create the database model.
     //
     bool gen_schema (ops.generate_schema () && db != database::common);
@@ -251,8 +273,11 @@ generate (options const& ops,
       // old one.
       //
       if (!ops.init_changelog ())
+      {
+        report_input (in_log_path);
         log.open (in_log_path.string ().c_str (),
                   ios_base::in | ios_base::binary);
+      }
 
       if (log.is_open ()) // The changelog might not exist.
       {
@@ -1021,6 +1046,12 @@ generate (options const& ops,
     if (ops.show_sloc () || ops.sloc_limit_specified ())
       cout << "odb:sloc:" << sloc_total << endl;
 
+    // Communicate the generated files to the driver for caching.
+    //
+    for (paths::const_iterator i (output_files.begin ());
+         i != output_files.end (); ++i)
+      cout << "odb:output:" << i->string () << endl;
+
     auto_rm.cancel ();
   }
   catch (operation_failed const&)
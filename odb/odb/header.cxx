@@ -806,6 +806,8 @@ namespace header
     {
       if (ctx.options.session_type () == "odb::session")
         os << "#include <odb/session.hxx>" << endl;
+      else if (ctx.options.session_type () == "odb::hash_session")
+        os << "#include <odb/hash-session.hxx>" << endl;
 
       os << "#include <odb/cache-traits.hxx>" << endl;
     }
@@ -14,6 +14,9 @@
 #  include <unistd.h>    // execvp, fork, dup2, pipe, {STDIN,STDERR}_FILENO
 #  include <sys/types.h> // waitpid
 #  include <sys/wait.h>  // waitpid
+#  include <poll.h>      // poll
+#  include <fcntl.h>     // fcntl
+#  include <signal.h>    // signal, SIGPIPE
 #else
 #  ifndef WIN32_LEAN_AND_MEAN
 #    define WIN32_LEAN_AND_MEAN
@@ -34,6 +37,7 @@
 #include <libcutl/fs/path.hxx>
 #include <libcutl/fs/auto-remove.hxx>
 
+#include <odb/cache.hxx>
 #include <odb/version.hxx>
 #include <odb/options.hxx>
 #include <odb/profile.hxx>
@@ -122,6 +126,46 @@ start_process (char const* args[],
 static bool
 wait_process (process_info, char const* name);
 
+// Filter the plugin's stdout looking for communication from the plugin
+// (odb:sloc:, odb:input:, and odb:output: lines) and copy everything else
+// to our stdout. Add the SLOC counts to sloc_total if sloc is true. Issue
+// diagnostics and return false if anything goes wrong.
+//
+static bool
+filter_output (istream&, char const* name, bool sloc, size_t& sloc_total);
+
+#ifndef _WIN32
+// Plugin invocation that is deferred in order to be run in parallel with
+// others (--jobs) or to first be looked up in the cache (--cache-dir).
+//
+struct plugin_job
+{
+  strings args;    // Plugin command line (without the terminating NULL).
+  strings pp_args; // Preprocessor command line or empty if not caching.
+  string input;    // Synthesized translation unit to send to the plugin.
+
+  string out;      // Buffered plugin stdout.
+  string err;      // Buffered plugin stderr.
+};
+
+// Run the plugin jobs with at most max_jobs processes at a time. The
+// output of each job is buffered and printed in the job order once it
+// has terminated so that the diagnostics do not interleave. Once a job
+// fails, no new jobs are started. For jobs with the preprocessor command
+// line, first preprocess the input and try to restore the result from
+// the cache in cache_dir. Return true if all the jobs completed
+// successfully. Issue diagnostics and throw process_failure or
+// cache_failure if anything goes wrong.
+//
+static bool
+run_jobs (vector<plugin_job>&,
+          size_t max_jobs,
+          cutl::fs::path const& cache_dir,
+          char const* name,
+          bool sloc,
+          size_t& sloc_total);
+#endif
+
 //
 //
 static string
@@ -603,6 +647,10 @@ main (int argc, char* argv[])
     vector<database> dbs;
     bool show_sloc;
     size_t sloc_limit;
+    size_t jobs;
+#ifndef _WIN32
+    path cache_dir;
+#endif
     {
       oi[1].search_func = &profile_search_ignore;
       oi[2].search_func = &profile_search_ignore;
@@ -683,6 +731,24 @@ main (int argc, char* argv[])
       show_sloc = ops.show_sloc ();
       sloc_limit = ops.sloc_limit_specified () ? ops.sloc_limit () : 0;
 
+      if (ops.batch_load_size () == 0)
+      {
+        e << argv[0] << ": error: --batch-load-size value should be " <<
+          "greater than zero" << endl;
+        return 1;
+      }
+
+      // Running the plugin in parallel is not supported on Windows.
+      //
+#ifndef _WIN32
+      jobs = ops.jobs ();
+
+      if (ops.cache_dir_specified ())
+        cache_dir = path (ops.cache_dir ());
+#else
+      jobs = 1;
+#endif
+
       // Translate some ODB options to GCC options.
       //
       switch (ops.std ())
@@ -750,6 +816,13 @@ main (int argc, char* argv[])
     //
     size_t sloc_total (0);
 
+#ifndef _WIN32
+    // Plugin invocations deferred to be run in parallel (--jobs) or
+    // looked up in the cache (--cache-dir).
+    //
+    vector<plugin_job> pending;
+#endif
+
     for (vector<database>::iterator i (dbs.begin ()); i != dbs.end (); ++i)
     {
       database db (*i);
@@ -912,20 +985,11 @@ main (int argc, char* argv[])
           }
         }
 
-        // Deal with Windows command line length limit.
+        // Synthesize the translation unit. We do it before starting the
+        // plugin so that it can also be handed over to a deferred job.
         //
-#ifdef _WIN32
-        string ops_file_arg;
-        auto_remove opt_file_rm (
-          fixup_cmd_line (exec_args, 1, argv[0], ops_file_arg));
-#endif
-
-        process_info pi (start_process (&exec_args[0], argv[0], false, true));
-
+        ostringstream os (ios_base::out | ios_base::binary);
         {
-          __gnu_cxx::stdio_filebuf<char> fb (
-            pi.out_fd, ios_base::out | ios_base::binary);
-          ostream os (&fb);
 
           if (!at_once)
           {
@@ -938,8 +1002,6 @@ main (int argc, char* argv[])
               if (ifs.get () != 0xBB || ifs.get () != 0xBF)
               {
                 e << name << ": error: invalid UTF-8 BOM sequence" << endl;
-                fb.close ();
-                wait_process (pi, argv[0]);
                 return 1;
               }
 
@@ -1022,16 +1084,12 @@ main (int argc, char* argv[])
               if (!ifs.is_open ())
               {
                 e << prof[i] << ": error: unable to open in read mode" << endl;
-                fb.close ();
-                wait_process (pi, argv[0]);
                 return 1;
               }
 
               if (!(os << ifs.rdbuf ()))
               {
                 e << prof[i] << ": error: io failure" << endl;
-                fb.close ();
-                wait_process (pi, argv[0]);
                 return 1;
               }
 
@@ -1060,8 +1118,6 @@ main (int argc, char* argv[])
             if (!(os << ifs.rdbuf ()))
             {
               e << name << ": error: io failure" << endl;
-              fb.close ();
-              wait_process (pi, argv[0]);
               return 1;
             }
 
@@ -1099,16 +1155,12 @@ main (int argc, char* argv[])
               if (!ifs.is_open ())
               {
                 e << epif[i] << ": error: unable to open in read mode" << endl;
-                fb.close ();
-                wait_process (pi, argv[0]);
                 return 1;
               }
 
               if (!(os << ifs.rdbuf ()))
               {
                 e << epif[i] << ": error: io failure" << endl;
-                fb.close ();
-                wait_process (pi, argv[0]);
                 return 1;
               }
 
@@ -1156,52 +1208,66 @@ main (int argc, char* argv[])
           }
         }
 
-        // Filter the output stream looking for communication from the
-        // plugin.
-        //
+#ifndef _WIN32
+        if (jobs > 1 || !cache_dir.empty ())
         {
-          __gnu_cxx::stdio_filebuf<char> fb (pi.in_ofd, ios_base::in);
-          istream is (&fb);
+          pending.push_back (plugin_job ());
+          plugin_job& j (pending.back ());
 
-          for (bool first (true); !is.eof (); )
-          {
-            string line;
-            getline (is, line);
+          j.args.assign (db_args.begin (), db_args.end ());
+          j.args.push_back ("-");
+          j.input = os.str ();
 
-            if (is.fail () && !is.eof ())
+          // To check the cache we preprocess the translation unit with the
+          // same options but without loading the plugin.
+          //
+          if (!cache_dir.empty ())
+          {
+            for (strings::const_iterator i (j.args.begin ());
+                 i != j.args.end (); ++i)
             {
-              e << argv[0] << ": error: io failure while parsing output"
-                << endl;
-              wait_process (pi, argv[0]);
-              return 1;
+              if (i->compare (0, 8, "-fplugin") == 0)
+                continue;
+
+              j.pp_args.push_back (*i == "-S" ? string ("-E") : *i);
             }
+          }
 
-            if (line.compare (0, 9, "odb:sloc:") == 0)
-            {
-              if (show_sloc || sloc_limit != 0)
-              {
-                size_t n;
-                istringstream is (string (line, 9, string::npos));
+          continue;
+        }
+#endif
 
-                if (!(is >> n && is.eof ()))
-                {
-                  e << argv[0] << ": error: invalid odb:sloc value" << endl;
-                  wait_process (pi, argv[0]);
-                  return 1;
-                }
+        // Deal with Windows command line length limit.
+        //
+#ifdef _WIN32
+        string ops_file_arg;
+        auto_remove opt_file_rm (
+          fixup_cmd_line (exec_args, 1, argv[0], ops_file_arg));
+#endif
 
-                sloc_total += n;
-              }
+        process_info pi (start_process (&exec_args[0], argv[0], false, true));
 
-              continue;
-            }
+        {
+          __gnu_cxx::stdio_filebuf<char> fb (
+            pi.out_fd, ios_base::out | ios_base::binary);
+          ostream ps (&fb);
 
-            if (first)
-              first = false;
-            else
-              cout << endl;
+          string const& tu (os.str ());
+          ps.write (tu.c_str (), static_cast<streamsize> (tu.size ()));
+        }
+
+        // Filter the output stream looking for communication from the
+        // plugin.
+        //
+        {
+          __gnu_cxx::stdio_filebuf<char> fb (pi.in_ofd, ios_base::in);
+          istream is (&fb);
 
-            cout << line;
+          if (!filter_output (
+                is, argv[0], show_sloc || sloc_limit != 0, sloc_total))
+          {
+            wait_process (pi, argv[0]);
+            return 1;
           }
         }
 
@@ -1210,6 +1276,17 @@ main (int argc, char* argv[])
       } // End input file loop.
     } // End database loop.
 
+#ifndef _WIN32
+    if (!pending.empty () &&
+        !run_jobs (pending,
+                   jobs,
+                   cache_dir,
+                   argv[0],
+                   show_sloc || sloc_limit != 0,
+                   sloc_total))
+      return 1;
+#endif
+
     // Handle SLOC.
     //
     if (show_sloc)
@@ -1239,6 +1316,12 @@ main (int argc, char* argv[])
     //
     return 1;
   }
+  catch (cache_failure const&)
+  {
+    // Diagnostics has already been issued.
+    //
+    return 1;
+  }
   catch (invalid_path const& ex)
   {
     e << argv[0] << ": error: invalid path '" << ex.path () << "'" << endl;
@@ -1732,6 +1815,56 @@ plugin_path (path const& drv,
 // Process manipulation.
 //
 
+static bool
+filter_output (istream& is, char const* name, bool sloc, size_t& sloc_total)
+{
+  for (bool first (true); !is.eof (); )
+  {
+    string line;
+    getline (is, line);
+
+    if (is.fail () && !is.eof ())
+    {
+      cerr << name << ": error: io failure while parsing output" << endl;
+      return false;
+    }
+
+    if (line.compare (0, 9, "odb:sloc:") == 0)
+    {
+      if (sloc)
+      {
+        size_t n;
+        istringstream is (string (line, 9, string::npos));
+
+        if (!(is >> n && is.eof ()))
+        {
+          cerr << name << ": error: invalid odb:sloc value" << endl;
+          return false;
+        }
+
+        sloc_total += n;
+      }
+
+      continue;
+    }
+
+    // Skip the files reported for caching (see cache.hxx).
+    //
+    if (line.compare (0, 10, "odb:input:") == 0 ||
+        line.compare (0, 11, "odb:output:") == 0)
+      continue;
+
+    if (first)
+      first = false;
+    else
+      cout << endl;
+
+    cout << line;
+  }
+
+  return true;
+}
+
 #ifndef _WIN32
 
 static process_info
@@ -1845,6 +1978,314 @@ wait_process (process_info pi, char const* name)
   return WIFEXITED (status) && WEXITSTATUS (status) == 0;
 }
 
+struct job_state
+{
+  process_info pi; // Our ends of the pipes are -1 once closed.
+  size_t written;  // Amount of input sent to the process so far.
+  bool plugin;     // Running the plugin rather than the preprocessor.
+  bool done;       // Terminated and waited for.
+  bool ok;
+  string key;      // Cache key or empty if not caching.
+};
+
+static void
+close_fd (int& fd, char const* name)
+{
+  if (close (fd) == -1)
+  {
+    char const* err (strerror (errno));
+    cerr << name << ": error: " <<  err << endl;
+    throw process_failure ();
+  }
+
+  fd = -1;
+}
+
+static void
+start_job (plugin_job& j,
+           job_state& s,
+           strings const& args,
+           char const* name)
+{
+  vector<char const*> exec_args;
+  for (strings::const_iterator i (args.begin ()); i != args.end (); ++i)
+    exec_args.push_back (i->c_str ());
+  exec_args.push_back (0);
+
+  s.pi = start_process (&exec_args[0], name, true, true);
+  s.written = 0;
+
+  // Our ends of the pipes must not be inherited by the processes that we
+  // start later since that would prevent this process from seeing the end
+  // of its input. Also, we should be able to drain the output while the
+  // process is not ready to read more input.
+  //
+  if (fcntl (s.pi.out_fd, F_SETFD, FD_CLOEXEC) == -1 ||
+      fcntl (s.pi.in_efd, F_SETFD, FD_CLOEXEC) == -1 ||
+      fcntl (s.pi.in_ofd, F_SETFD, FD_CLOEXEC) == -1 ||
+      fcntl (s.pi.out_fd, F_SETFL, O_NONBLOCK) == -1)
+  {
+    char const* err (strerror (errno));
+    cerr << name << ": error: " <<  err << endl;
+    throw process_failure ();
+  }
+
+  if (j.input.empty ())
+    close_fd (s.pi.out_fd, name);
+}
+
+static bool
+run_jobs (vector<plugin_job>& js,
+          size_t max_jobs,
+          path const& cache_dir,
+          char const* name,
+          bool sloc,
+          size_t& sloc_total)
+{
+  // A plugin that fails before reading all its input should result in
+  // EPIPE rather than in us being terminated.
+  //
+  signal (SIGPIPE, SIG_IGN);
+
+  // The generated file paths can be relative to the current directory so
+  // it is part of the cache key.
+  //
+  string cwd;
+  if (!cache_dir.empty ())
+  {
+    vector<char> b (256);
+
+    while (getcwd (&b[0], b.size ()) == 0)
+    {
+      if (errno != ERANGE)
+      {
+        char const* err (strerror (errno));
+        cerr << name << ": error: " <<  err << endl;
+        throw process_failure ();
+      }
+
+      b.resize (b.size () * 2);
+    }
+
+    cwd = &b[0];
+  }
+
+  vector<job_state> ss (js.size ());
+  vector<pollfd> fds;
+  vector<size_t> fjs; // Job index for each entry in fds.
+
+  size_t started (0), running (0), printed (0);
+  bool failed (false);
+  char buf[8192];
+
+  while (printed != started || (!failed && started != js.size ()))
+  {
+    // Start as many new jobs as we are allowed to.
+    //
+    for (; !failed && running < max_jobs && started != js.size ();
+         ++started, ++running)
+    {
+      plugin_job& j (js[started]);
+      job_state& s (ss[started]);
+
+      s.plugin = j.pp_args.empty ();
+      s.done = false;
+      s.ok = false;
+
+      start_job (j, s, s.plugin ? j.args : j.pp_args, name);
+    }
+
+    // Wait until we can send input to or receive output from any of the
+    // running plugins.
+    //
+    fds.clear ();
+    fjs.clear ();
+
+    for (size_t i (printed); i != started; ++i)
+    {
+      job_state& s (ss[i]);
+
+      if (s.done)
+        continue;
+
+      int fd[3] = {s.pi.out_fd, s.pi.in_ofd, s.pi.in_efd};
+
+      for (size_t k (0); k != 3; ++k)
+      {
+        if (fd[k] == -1)
+          continue;
+
+        pollfd p;
+        p.fd = fd[k];
+        p.events = k == 0 ? POLLOUT : POLLIN;
+        p.revents = 0;
+
+        fds.push_back (p);
+        fjs.push_back (i);
+      }
+    }
+
+    if (!fds.empty ())
+    {
+      if (poll (&fds[0], static_cast<nfds_t> (fds.size ()), -1) == -1)
+      {
+        if (errno == EINTR)
+          continue;
+
+        char const* err (strerror (errno));
+        cerr << name << ": error: " <<  err << endl;
+        throw process_failure ();
+      }
+
+      for (size_t k (0); k != fds.size (); ++k)
+      {
+        if (fds[k].revents == 0)
+          continue;
+
+        plugin_job& j (js[fjs[k]]);
+        job_state& s (ss[fjs[k]]);
+
+        if (fds[k].fd == s.pi.out_fd)
+        {
+          ssize_t n (write (s.pi.out_fd,
+                            j.input.c_str () + s.written,
+                            j.input.size () - s.written));
+
+          if (n == -1)
+          {
+            if (errno == EINTR || errno == EAGAIN)
+              continue;
+
+            // The plugin has terminated without reading all its input.
+            // Its exit status will tell us what happened.
+            //
+            if (errno != EPIPE)
+            {
+              char const* err (strerror (errno));
+              cerr << name << ": error: " <<  err << endl;
+              throw process_failure ();
+            }
+
+            close_fd (s.pi.out_fd, name);
+          }
+          else if ((s.written += static_cast<size_t> (n)) == j.input.size ())
+            close_fd (s.pi.out_fd, name);
+        }
+        else
+        {
+          int& fd (fds[k].fd == s.pi.in_ofd ? s.pi.in_ofd : s.pi.in_efd);
+          ssize_t n (read (fd, buf, sizeof (buf)));
+
+          if (n == -1)
+          {
+            if (errno == EINTR || errno == EAGAIN)
+              continue;
+
+            char const* err (strerror (errno));
+            cerr << name << ": error: " <<  err << endl;
+            throw process_failure ();
+          }
+
+          if (n == 0)
+            close_fd (fd, name);
+          else
+            (&fd == &s.pi.in_ofd ? j.out : j.err).append (
+              buf, static_cast<size_t> (n));
+        }
+      }
+    }
+
+    // Reap the processes that are done with their input and output.
+    //
+    for (size_t i (printed); i != started; ++i)
+    {
+      plugin_job& j (js[i]);
+      job_state& s (ss[i]);
+
+      if (s.done ||
+          s.pi.out_fd != -1 || s.pi.in_ofd != -1 || s.pi.in_efd != -1)
+        continue;
+
+      bool ok (wait_process (s.pi, name));
+
+      if (!s.plugin)
+      {
+        // Calculate the cache key from the preprocessed translation unit
+        // and try to restore the result. If the preprocessing failed, then
+        // we let the plugin issue the diagnostics.
+        //
+        if (ok)
+        {
+          // The driver is built with the same GCC as the plugin (which has
+          // to match the GCC it is loaded into) so __VERSION__ identifies
+          // the host GCC.
+          //
+          sha1 cs;
+          cs.append (ODB_COMPILER_VERSION_STR);
+          cs.append (__VERSION__);
+          cs.append (cwd);
+
+          for (strings::const_iterator a (j.args.begin ());
+               a != j.args.end (); ++a)
+            cs.append (*a);
+
+          cs.append (j.out.c_str (), j.out.size ());
+          s.key = cs.string ();
+
+          if (cache_restore (cache_dir, s.key, j.out, j.err, name))
+          {
+            s.ok = true;
+            s.done = true;
+            running--;
+            continue;
+          }
+        }
+
+        j.out.clear ();
+        j.err.clear ();
+
+        s.plugin = true;
+        start_job (j, s, j.args, name);
+        continue;
+      }
+
+      if (ok && !s.key.empty ())
+        cache_store (cache_dir, s.key, j.out, j.err, name);
+
+      s.ok = ok;
+      s.done = true;
+      running--;
+    }
+
+    // Print the output of the terminated jobs in order.
+    //
+    for (; printed != started && ss[printed].done; ++printed)
+    {
+      plugin_job& j (js[printed]);
+      job_state& s (ss[printed]);
+
+      cerr << j.err;
+
+      istringstream is (j.out);
+      if (!filter_output (is, name, sloc, sloc_total))
+        s.ok = false;
+
+      cout << flush;
+
+      if (!s.ok)
+        failed = true;
+
+      // Free the buffers as we go.
+      //
+      string ().swap (j.input);
+      string ().swap (j.out);
+      string ().swap (j.err);
+    }
+  }
+
+  return !failed;
+}
+
 #else // _WIN32
 
 static void
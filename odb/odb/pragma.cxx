@@ -511,7 +511,8 @@ check_spec_decl_type (declaration const& d,
            p == "polymorphic" ||
            p == "definition" ||
            p == "sectionable" ||
-           p == "bulk")
+           p == "bulk" ||
+           p == "dirty_tracking")
   {
     if (tc != RECORD_TYPE)
     {
@@ -1593,6 +1594,18 @@ handle_pragma (cxx_lexer& l,
 
     tt = l.next (tl, &tn);
   }
+  else if (p == "dirty_tracking")
+  {
+    // dirty_tracking
+    //
+
+    // Make sure we've got the correct declaration type.
+    //
+    if (decl && !check_spec_decl_type (decl, decl_name, p, loc))
+      return;
+
+    tt = l.next (tl, &tn);
+  }
   else if (p == "callback")
   {
     // callback (name)
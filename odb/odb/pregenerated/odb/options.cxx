@@ -788,6 +788,10 @@ options ()
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -954,6 +958,10 @@ options ()
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -1001,6 +1009,10 @@ options (int& argc,
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -1167,6 +1179,10 @@ options (int& argc,
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -1217,6 +1233,10 @@ options (int start,
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -1383,6 +1403,10 @@ options (int start,
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -1433,6 +1457,10 @@ options (int& argc,
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -1599,6 +1627,10 @@ options (int& argc,
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -1651,6 +1683,10 @@ options (int start,
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -1817,6 +1853,10 @@ options (int start,
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -1865,6 +1905,10 @@ options (::cli::scanner& s,
   generate_query_ (),
   generate_prepared_ (),
   omit_unprepared_ (),
+  generate_batch_load_ (),
+  batch_load_size_ (16),
+  batch_load_size_specified_ (false),
+  generate_polymorphic_join_ (),
   generate_session_ (),
   generate_schema_ (),
   generate_schema_only_ (),
@@ -2031,6 +2075,10 @@ options (::cli::scanner& s,
   show_sloc_ (),
   sloc_limit_ (),
   sloc_limit_specified_ (false),
+  jobs_ (1),
+  jobs_specified_ (false),
+  cache_dir_ (),
+  cache_dir_specified_ (false),
   options_file_ (),
   options_file_specified_ (false),
   x_ (),
@@ -2091,6 +2139,15 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
   os << "--omit-unprepared             Omit un-prepared (once-off) query execution" << ::std::endl
      << "                              support code." << ::std::endl;
 
+  os << "--generate-batch-load         Generate code for loading containers of objects" << ::std::endl
+     << "                              returned by a query in batches." << ::std::endl;
+
+  os << "--batch-load-size <num>       Load containers of at most <num> objects at once" << ::std::endl
+     << "                              with --generate-batch-load." << ::std::endl;
+
+  os << "--generate-polymorphic-join   Generate code for loading polymorphic objects" << ::std::endl
+     << "                              returned by a query with a single statement." << ::std::endl;
+
   os << "--generate-session|-e         Generate session support code." << ::std::endl;
 
   os << "--generate-schema|-s          Generate the database schema." << ::std::endl;
@@ -2382,6 +2439,15 @@ print_usage (::std::ostream& os, ::cli::usage_para p)
      << "                              source lines of code (SLOC) does not exceed" << ::std::endl
      << "                              <num>." << ::std::endl;
 
+  os << "--jobs <num>                  Run at most <num> ODB compiler plugin processes" << ::std::endl
+     << "                              in parallel when compiling multiple input files" << ::std::endl
+     << "                              or for multiple databases." << ::std::endl;
+
+  os << "--cache-dir <dir>             Cache the generated files in <dir> and restore" << ::std::endl
+     << "                              them instead of running the ODB compiler plugin" << ::std::endl
+     << "                              if neither the input nor the options have" << ::std::endl
+     << "                              changed." << ::std::endl;
+
   os << "--options-file <file>         Read additional options from <file>." << ::std::endl;
 
   os << "-x <option>                   Pass <option> to the underlying C++ compiler" << ::std::endl
@@ -2547,6 +2613,33 @@ fill (::cli::options& os)
     os.push_back (o);
   }
 
+  // --generate-batch-load
+  //
+  {
+    ::cli::option_names a;
+    std::string dv;
+    ::cli::option o ("--generate-batch-load", a, true, dv);
+    os.push_back (o);
+  }
+
+  // --batch-load-size
+  //
+  {
+    ::cli::option_names a;
+    std::string dv ("16");
+    ::cli::option o ("--batch-load-size", a, false, dv);
+    os.push_back (o);
+  }
+
+  // --generate-polymorphic-join
+  //
+  {
+    ::cli::option_names a;
+    std::string dv;
+    ::cli::option o ("--generate-polymorphic-join", a, true, dv);
+    os.push_back (o);
+  }
+
   // --generate-session
   //
   {
@@ -3379,6 +3472,24 @@ fill (::cli::options& os)
     os.push_back (o);
   }
 
+  // --jobs
+  //
+  {
+    ::cli::option_names a;
+    std::string dv ("1");
+    ::cli::option o ("--jobs", a, false, dv);
+    os.push_back (o);
+  }
+
+  // --cache-dir
+  //
+  {
+    ::cli::option_names a;
+    std::string dv;
+    ::cli::option o ("--cache-dir", a, false, dv);
+    os.push_back (o);
+  }
+
   // --options-file
   //
   {
@@ -3543,6 +3654,13 @@ struct _cli_options_map_init
     &::cli::thunk< options, &options::generate_prepared_ >;
     _cli_options_map_["--omit-unprepared"] =
     &::cli::thunk< options, &options::omit_unprepared_ >;
+    _cli_options_map_["--generate-batch-load"] =
+    &::cli::thunk< options, &options::generate_batch_load_ >;
+    _cli_options_map_["--batch-load-size"] =
+    &::cli::thunk< options, std::size_t, &options::batch_load_size_,
+      &options::batch_load_size_specified_ >;
+    _cli_options_map_["--generate-polymorphic-join"] =
+    &::cli::thunk< options, &options::generate_polymorphic_join_ >;
     _cli_options_map_["--generate-session"] =
     &::cli::thunk< options, &options::generate_session_ >;
     _cli_options_map_["-e"] =
@@ -3810,6 +3928,12 @@ struct _cli_options_map_init
     &::cli::thunk< options, &options::show_sloc_ >;
     _cli_options_map_["--sloc-limit"] =
     &::cli::thunk< options, std::size_t, &options::sloc_limit_,
+    _cli_options_map_["--jobs"] =
+    &::cli::thunk< options, std::size_t, &options::jobs_,
+    _cli_options_map_["--cache-dir"] =
+    &::cli::thunk< options, std::string, &options::cache_dir_,
+      &options::cache_dir_specified_ >;
+      &options::jobs_specified_ >;
       &options::sloc_limit_specified_ >;
     _cli_options_map_["--options-file"] =
     &::cli::thunk< options, std::string, &options::options_file_,
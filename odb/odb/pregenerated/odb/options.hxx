@@ -673,6 +673,39 @@ class options
   void
   omit_unprepared (const bool&);
 
+  const bool&
+  generate_batch_load () const;
+
+  bool&
+  generate_batch_load ();
+
+  void
+  generate_batch_load (const bool&);
+
+  const std::size_t&
+  batch_load_size () const;
+
+  std::size_t&
+  batch_load_size ();
+
+  void
+  batch_load_size (const std::size_t&);
+
+  bool
+  batch_load_size_specified () const;
+
+  void
+  batch_load_size_specified (bool);
+
+  const bool&
+  generate_polymorphic_join () const;
+
+  bool&
+  generate_polymorphic_join ();
+
+  void
+  generate_polymorphic_join (const bool&);
+
   const bool&
   generate_session () const;
 
@@ -1939,6 +1972,36 @@ class options
   void
   sloc_limit (const std::size_t&);
 
+  const std::size_t&
+  jobs () const;
+
+  std::size_t&
+  jobs ();
+
+  void
+  jobs (const std::size_t&);
+
+  const std::string&
+  cache_dir () const;
+
+  std::string&
+  cache_dir ();
+
+  void
+  cache_dir (const std::string&);
+
+  bool
+  cache_dir_specified () const;
+
+  void
+  cache_dir_specified (bool);
+
+  bool
+  jobs_specified () const;
+
+  void
+  jobs_specified (bool);
+
   bool
   sloc_limit_specified () const;
 
@@ -2143,6 +2206,10 @@ class options
   bool generate_query_;
   bool generate_prepared_;
   bool omit_unprepared_;
+  bool generate_batch_load_;
+  std::size_t batch_load_size_;
+  bool batch_load_size_specified_;
+  bool generate_polymorphic_join_;
   bool generate_session_;
   bool generate_schema_;
   bool generate_schema_only_;
@@ -2308,7 +2375,11 @@ class options
   bool guard_prefix_specified_;
   bool show_sloc_;
   std::size_t sloc_limit_;
+  std::size_t jobs_;
+  std::string cache_dir_;
   bool sloc_limit_specified_;
+  bool jobs_specified_;
+  bool cache_dir_specified_;
   std::string options_file_;
   bool options_file_specified_;
   std::vector<std::string> x_;
@@ -621,6 +621,72 @@ omit_unprepared (const bool& x)
   this->omit_unprepared_ = x;
 }
 
+inline const bool& options::
+generate_batch_load () const
+{
+  return this->generate_batch_load_;
+}
+
+inline bool& options::
+generate_batch_load ()
+{
+  return this->generate_batch_load_;
+}
+
+inline void options::
+generate_batch_load (const bool& x)
+{
+  this->generate_batch_load_ = x;
+}
+
+inline const std::size_t& options::
+batch_load_size () const
+{
+  return this->batch_load_size_;
+}
+
+inline std::size_t& options::
+batch_load_size ()
+{
+  return this->batch_load_size_;
+}
+
+inline void options::
+batch_load_size (const std::size_t& x)
+{
+  this->batch_load_size_ = x;
+}
+
+inline bool options::
+batch_load_size_specified () const
+{
+  return this->batch_load_size_specified_;
+}
+
+inline void options::
+batch_load_size_specified (bool x)
+{
+  this->batch_load_size_specified_ = x;
+}
+
+inline const bool& options::
+generate_polymorphic_join () const
+{
+  return this->generate_polymorphic_join_;
+}
+
+inline bool& options::
+generate_polymorphic_join ()
+{
+  return this->generate_polymorphic_join_;
+}
+
+inline void options::
+generate_polymorphic_join (const bool& x)
+{
+  this->generate_polymorphic_join_ = x;
+}
+
 inline const bool& options::
 generate_session () const
 {
@@ -3165,6 +3231,66 @@ sloc_limit_specified (bool x)
   this->sloc_limit_specified_ = x;
 }
 
+inline const std::size_t& options::
+jobs () const
+{
+  return this->jobs_;
+}
+
+inline std::size_t& options::
+jobs ()
+{
+  return this->jobs_;
+}
+
+inline void options::
+jobs (const std::size_t& x)
+{
+  this->jobs_ = x;
+}
+
+inline bool options::
+jobs_specified () const
+{
+  return this->jobs_specified_;
+}
+
+inline void options::
+jobs_specified (bool x)
+{
+  this->jobs_specified_ = x;
+}
+
+inline const std::string& options::
+cache_dir () const
+{
+  return this->cache_dir_;
+}
+
+inline std::string& options::
+cache_dir ()
+{
+  return this->cache_dir_;
+}
+
+inline void options::
+cache_dir (const std::string& x)
+{
+  this->cache_dir_ = x;
+}
+
+inline bool options::
+cache_dir_specified () const
+{
+  return this->cache_dir_specified_;
+}
+
+inline void options::
+cache_dir_specified (bool x)
+{
+  this->cache_dir_specified_ = x;
+}
+
 inline const std::string& options::
 options_file () const
 {
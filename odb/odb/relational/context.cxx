@@ -28,6 +28,10 @@ namespace relational
         delay_freeing_statement_result (current ().delay_freeing_statement_result),
         need_image_clone (current ().need_image_clone),
         generate_bulk (current ().generate_bulk),
+        generate_batch_load (current ().generate_batch_load),
+        generate_dirty_tracking (current ().generate_dirty_tracking),
+        generate_load_many (current ().generate_load_many),
+        generate_polymorphic_join (current ().generate_polymorphic_join),
         global_index (current ().global_index),
         global_fkey (current ().global_fkey),
         bind_vector (data_->bind_vector_),
@@ -275,6 +275,10 @@ namespace relational
     bool delay_freeing_statement_result;
     bool need_image_clone;
     bool generate_bulk;
+    bool generate_batch_load;
+    bool generate_dirty_tracking;
+    bool generate_load_many;
+    bool generate_polymorphic_join;
 
     bool global_index;
     bool global_fkey;
@@ -480,6 +480,13 @@ traverse_object (type& c)
        << "static const char erase_query_statement[];"
        << endl
        << "static const char table_name[];";
+
+    // Derived class columns in the polymorphic query statement.
+    //
+    if (c.count ("polymorphic-join"))
+      os << endl
+         << "static const " << db << "::polymorphic_join_column " <<
+        "polymorphic_join_columns[];";
   }
 
   os << endl;
@@ -631,6 +638,14 @@ traverse_object (type& c)
         os << "static result<object_type>" << endl
            << "query (database&, const odb::query_base&);"
            << endl;
+
+      // find (ids)
+      //
+      if (generate_load_many &&
+          id != 0 && !poly && !abst && !composite_wrapper (utype (*id)))
+        os << "static result<object_type>" << endl
+           << "find (database&, const id_type**, std::size_t);"
+           << endl;
     }
 
     os << "static unsigned long long" << endl
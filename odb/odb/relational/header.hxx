@@ -462,6 +462,11 @@ namespace relational
           os << "static const char insert_statement[];"
              << "static const char select_statement[];";
 
+          // Batch load statement (see the batch-load processor logic).
+          //
+          if (!base && !inverse && !versioned && c_.count ("batch-load"))
+            os << "static const char batch_select_statement[];";
+
           if (smart)
             os << "static const char update_statement[];";
 
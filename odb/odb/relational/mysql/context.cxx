@@ -84,6 +84,10 @@ namespace relational
       delay_freeing_statement_result = false;
       need_image_clone = false;
       generate_bulk = false;
+      generate_batch_load = false;
+      generate_dirty_tracking = false;
+      generate_load_many = false;
+      generate_polymorphic_join = false;
       global_index = false;
       global_fkey = true;
       data_->bind_vector_ = "MYSQL_BIND*";
@@ -86,6 +86,10 @@ namespace relational
       delay_freeing_statement_result = false;
       need_image_clone = false;
       generate_bulk = true;
+      generate_batch_load = false;
+      generate_dirty_tracking = false;
+      generate_load_many = false;
+      generate_polymorphic_join = false;
       global_index = true;
       global_fkey = false;
       data_->bind_vector_ = "pgsql::bind*";
@@ -1035,6 +1035,76 @@ namespace relational
         if (c.count ("bulk") && !generate_bulk)
           c.remove ("bulk");
 
+        // Likewise for dirty tracking. There is also nothing to track if
+        // the object cannot be updated.
+        //
+        if (c.count ("dirty-tracking") &&
+            (!generate_dirty_tracking || id_member (c) == 0 || readonly (c)))
+          c.remove ("dirty-tracking");
+
+        // Mark the object for batch loading of containers if requested
+        // and supported. We only handle the straightforward case: a
+        // concrete, non-polymorphic, non-versioned object with a simple
+        // id and containers that are all its own (containers from reuse
+        // bases are loaded with the base's statement texts).
+        //
+        if (options.generate_batch_load () && generate_batch_load)
+        {
+          data_member_path* id (id_member (c));
+
+          if (id != 0 &&
+              !composite_wrapper (utype (*id)) &&
+              !abstract (c) &&
+              polymorphic (c) == 0 &&
+              !versioned (c))
+          {
+            size_t n (has_a (c, test_straight_container));
+
+            if (n != 0 &&
+                n == has_a (c, test_straight_container | exclude_base))
+            {
+              c.set ("batch-load",
+                     static_cast<unsigned long long> (
+                       options.batch_load_size ()));
+            }
+          }
+        }
+
+        // Register a concrete, non-versioned polymorphic derived object
+        // with its bases so that their query statements can also load its
+        // dynamic part. Since the generated code for the base needs to
+        // see the derived class, we only do this for bases that are
+        // defined in the same file (or if all the files are compiled at
+        // once).
+        //
+        if (options.generate_polymorphic_join () && generate_polymorphic_join)
+        {
+          semantics::class_* root (polymorphic (c));
+
+          if (root != 0 && root != &c && !abstract (c) && !versioned (c))
+          {
+            for (semantics::class_* b (&polymorphic_base (c));;
+                 b = &polymorphic_base (*b))
+            {
+              if (!options.at_once () && class_file (*b) != class_file (c))
+                break;
+
+              if (!versioned (*b))
+              {
+                typedef std::vector<semantics::class_*> classes;
+
+                classes& cs (b->count ("polymorphic-join")
+                             ? b->get<classes> ("polymorphic-join")
+                             : b->set ("polymorphic-join", classes ()));
+                cs.push_back (&c);
+              }
+
+              if (b == root)
+                break;
+            }
+          }
+        }
+
         // Process indexes. Here we need to do two things: resolve member
         // names to member paths and assign names to unnamed indexes. We
         // are also going to handle the special container indexes.
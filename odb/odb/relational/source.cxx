@@ -2,6 +2,7 @@
 // license   : GNU GPL v3; see accompanying LICENSE file
 
 #include <map>
+#include <algorithm> // std::find
 
 #include <odb/gcc.hxx>
 
@@ -49,6 +50,7 @@ traverse_object (type& c)
 
   column_count_type const& cc (column_count (c));
   bool versioned (context::versioned (c));
+  bool dirty (c.count ("dirty-tracking") != 0 && id != 0 && !abst);
 
   // Schema name as a string literal or empty.
   //
@@ -954,7 +956,10 @@ traverse_object (type& c)
     //
     if (update_columns)
     {
-      string sep (versioned ? "\n" : " ");
+      // With dirty tracking the statement is processed to only set the
+      // changed columns.
+      //
+      string sep (versioned || dirty ? "\n" : " ");
 
       instance<query_parameters> qp (statement_update, table);
 
@@ -1079,6 +1084,7 @@ traverse_object (type& c)
   // query_statement
   //
   bool query_optimize (false);
+  bool poly_join (false);
   if (options.generate_query ())
   {
     // query_statement
@@ -1104,6 +1110,107 @@ traverse_object (type& c)
       joins.insert (joins.end (), j->begin (), j->end ());
     }
 
+    // Derived classes whose dynamic part is loaded from the query result
+    // (--generate-polymorphic-join). For each such class we add the same
+    // columns as in its find statement for our depth and LEFT JOIN the
+    // corresponding tables on our id. Derived classes that need their own
+    // joins to load the dynamic part or whose tables clash with our joins
+    // are loaded the usual way.
+    //
+    typedef std::vector<semantics::class_*> classes;
+
+    classes pj_classes;
+    std::vector<statement_columns> pj_columns;
+
+    if (c.count ("polymorphic-join"))
+    {
+      classes& ds (c.get<classes> ("polymorphic-join"));
+      strings::size_type n (joins.size ());
+
+      instance<object_columns_list> id_cols;
+      id_cols->traverse (*id);
+
+      for (classes::iterator i (ds.begin ()); i != ds.end (); ++i)
+      {
+        semantics::class_& dc (**i);
+        size_t d (polymorphic_depth (dc) - poly_depth);
+
+        {
+          bool f (false); //@@ (im)perfect forwarding
+          object_section* s (&main_section); //@@ (im)perfect forwarding
+          instance<object_joins> j (dc, f, d, s);
+          j->traverse (dc);
+
+          if (j->begin () != j->end ())
+            continue;
+        }
+
+        statement_columns sc;
+        {
+          string qt (table_qname (dc));
+          statement_kind sk (statement_select); //@@ Imperfect forwarding.
+          object_section* s (&main_section); //@@ Imperfect forwarding.
+          instance<object_columns> oc (qt, sk, sc, d, s);
+          oc->traverse (dc);
+          process_statement_columns (sc, statement_select, false);
+        }
+
+        if (sc.empty ())
+          continue;
+
+        bool clash (false);
+        strings js;
+
+        for (semantics::class_* l (&dc); d != 0; l = &polymorphic_base (*l))
+        {
+          --d;
+
+          // Skip intermediates that don't add any data members, the same
+          // as in the find statement.
+          //
+          column_count_type const& cc (column_count (*l));
+          if (cc.total == cc.id + cc.separate_load)
+            continue;
+
+          string t (quote_id (table_name (*l)));
+
+          for (strings::size_type k (0); !clash && k != n; ++k)
+            clash = joins[k].find (' ' + t + ' ') != string::npos;
+
+          string line ("LEFT JOIN " + t + " ON ");
+
+          for (object_columns_list::iterator b (id_cols->begin ()), k (b);
+               k != id_cols->end ();
+               ++k)
+          {
+            if (k != b)
+              line += " AND ";
+
+            string qn (quote_id (k->name));
+            line += t + '.' + qn + '=' + qtable + '.' + qn;
+          }
+
+          js.push_back (line);
+        }
+
+        if (clash)
+          continue;
+
+        // The same table can be needed by several derived classes.
+        //
+        for (strings::iterator j (js.begin ()); j != js.end (); ++j)
+        {
+          if (std::find (joins.begin () + n, joins.end (), *j) == joins.end ())
+            joins.push_back (*j);
+        }
+
+        pj_classes.push_back (&dc);
+        pj_columns.push_back (sc);
+      }
+
+      poly_join = !pj_classes.empty ();
+    }
+
     query_optimize = !joins.empty ();
 
     statement_columns sc;
@@ -1118,6 +1225,34 @@ traverse_object (type& c)
 
     string sep (versioned || query_optimize ? "\n" : " ");
 
+    // Append the derived class columns, calculating the first result
+    // column of each class' dynamic part.
+    //
+    std::vector<size_t> pj_starts;
+
+    if (poly_join)
+    {
+      size_t n (0);
+      for (statement_columns::const_iterator i (sc.begin ());
+           i != sc.end ();
+           ++i)
+        n += statement_column_width (*i);
+
+      for (std::vector<statement_columns>::iterator i (pj_columns.begin ());
+           i != pj_columns.end ();
+           ++i)
+      {
+        pj_starts.push_back (n);
+
+        for (statement_columns::const_iterator j (i->begin ());
+             j != i->end ();
+             ++j)
+          n += statement_column_width (*j);
+
+        sc.splice (sc.end (), *i);
+      }
+    }
+
     os << "const char " << traits << "::query_statement[] =" << endl
        << strlit ("SELECT" + sep) << endl;
 
@@ -1139,6 +1274,23 @@ traverse_object (type& c)
     os << strlit (prev) << ";"
        << endl;
 
+    // polymorphic_join_columns
+    //
+    if (c.count ("polymorphic-join"))
+    {
+      os << "const " << db << "::polymorphic_join_column " << traits <<
+        "::" << endl
+         << "polymorphic_join_columns[] ="
+         << "{";
+
+      for (size_t i (0); i != pj_classes.size (); ++i)
+        os << "{&typeid (" << class_fq_name (*pj_classes[i]) << "), " <<
+          pj_starts[i] << "UL}," << endl;
+
+      os << "{0, 0UL}"
+         << "};";
+    }
+
     // erase_query_statement
     //
     os << "const char " << traits << "::erase_query_statement[] =" << endl
@@ -1416,6 +1568,14 @@ traverse_object (type& c)
        << endl;
   }
 
+  // Record the dirty tracking snapshot so that the subsequent updates
+  // only set the changed columns.
+  //
+  if (dirty)
+    os << "sts.dirty_snapshot (id (obj), obj, " <<
+      (versioned ? "&svm" : "0") << ", true);"
+       << endl;
+
   // Call callback (post_persist).
   //
   if (!abst) // If we are poly-abstract, then top will always be false.
@@ -1462,9 +1622,8 @@ traverse_object (type& c)
        << "const object_type& obj (*objs[i]);"
        << "callback (db, obj, callback_event::pre_persist);"
       //@@ assumption: generate_grow is false or it only affects select (like
-      //               in pgsql) so all we have to do is to increment image
-      //               version if it grew.
-      //@@ assumption: insert_send_auto_id is false
+      //               in pgsql and sqlite) so all we have to do is to
+      //               increment image version if it grew.
        << "image_type& im (sts.image (i));";
 
     if (generate_grow)
@@ -1476,8 +1635,16 @@ traverse_object (type& c)
       os << " && i == 0)" << endl
          << "im.version++";
 
-    os << ";"
-       << "}";
+    os << ";";
+
+    if (auto_id && insert_send_auto_id)
+    {
+      string const& n (idf->name ());
+      string var ("im." + n + (n[n.size () - 1] == '_' ? "" : "_"));
+      init_auto_id (*idf, var); // idf == idb, since auto
+    }
+
+    os << "}";
 
     //@@ assumption: generate_grow: as above
     os << "binding& imb (sts.insert_image_binding ());"
@@ -1961,18 +2128,41 @@ traverse_object (type& c)
            << "imb.version++;"
            << "}";
 
-        os << "update_statement& st (sts.update_statement ());"
-           << "if (";
+        const char* ex (opt == 0
+                        ? "throw object_not_persistent ();"
+                        : "throw object_changed ();");
 
-        if (versioned)
-          os << "!st.empty () && ";
+        // With dirty tracking we get the statement that only sets the
+        // changed columns or NULL if nothing has changed.
+        //
+        if (dirty)
+        {
+          os << "const id_type& di (id (obj));"
+             << "update_statement* st (sts.dirty_update_statement (di));"
+             << "if (st != 0)"
+             << "{"
+             << "if (";
 
-        os << "st.execute () == 0)" << endl;
+          if (versioned)
+            os << "!st->empty () && ";
 
-        if (opt == 0)
-          os << "throw object_not_persistent ();";
+          os << "st->execute () == 0)" << endl
+             << ex
+             << endl
+             << "sts.dirty_update_snapshot (di);"
+             << "}";
+        }
         else
-          os << "throw object_changed ();";
+        {
+          os << "update_statement& st (sts.update_statement ());"
+             << "if (";
+
+          if (versioned)
+            os << "!st.empty () && ";
+
+          os << "st.execute () == 0)" << endl
+             << ex;
+        }
 
         os << endl;
       }
@@ -2436,6 +2626,10 @@ traverse_object (type& c)
        << "throw object_not_persistent ();"
        << endl;
 
+    if (dirty)
+      os << "sts.dirty_erase (id);"
+         << endl;
+
     if (poly_derived)
     {
       // Call our base last (we erase polymorphic objects from base
@@ -2788,6 +2982,9 @@ traverse_object (type& c)
         // transient and the state of a section in a transient object
         // is undefined.
 
+        if (dirty)
+          os << "sts.dirty_erase (id);";
+
         // Remove from the object cache.
         //
         os << "pointer_cache_traits::erase (db, id);";
@@ -3061,8 +3258,13 @@ traverse_object (type& c)
          << "pi.dispatch (info_type::call_load, db, &obj, &d);"
          << "}";
 
-    os << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");"
-       << "l.unlock ();";
+    os << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");";
+
+    if (dirty)
+      os << "sts.dirty_snapshot (id, obj, " << (versioned ? "&svm" : "0") <<
+        ", false);";
+
+    os << "l.unlock ();";
 
     if (poly)
       os << "ce = callback_event::post_load;"
@@ -3174,8 +3376,13 @@ traverse_object (type& c)
         os << "ar.free ();";
 
       os << "load_ (sts, obj, false" << (versioned ? ", svm" : "") << ");"
-         << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");"
-         << "l.unlock ();"
+         << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");";
+
+      if (dirty)
+        os << "sts.dirty_snapshot (id, obj, " << (versioned ? "&svm" : "0") <<
+          ", false);";
+
+      os << "l.unlock ();"
          << "callback (db, obj, callback_event::post_load);"
          << "reference_cache_traits::load (pos);"
          << "ig.release ();"
@@ -3289,8 +3496,13 @@ traverse_object (type& c)
         os << "ar.free ();";
 
       os << "load_ (sts, obj, true" << (versioned ? ", svm" : "") << ");"
-         << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");"
-         << "l.unlock ();"
+         << rsts << ".load_delayed (" << (versioned ? "&svm" : "0") << ");";
+
+      if (dirty)
+        os << "sts.dirty_snapshot (id, obj, " << (versioned ? "&svm" : "0") <<
+          ", false);";
+
+      os << "l.unlock ();"
          << "callback (db, obj, callback_event::post_load);"
          << "return true;";
     }
@@ -4213,7 +4425,7 @@ traverse_object (type& c)
 
       os << "q.init_parameters ();"
          << "shared_ptr<select_statement> st (" << endl
-         << "new (shared) select_statement (" << endl;
+         << query_statement_ctor (c) << " (" << endl;
       object_query_statement_ctor_args (
         c, "q", versioned || query_optimize, false);
       os << "));" << endl
@@ -4224,7 +4436,8 @@ traverse_object (type& c)
       os << endl
          << "shared_ptr< odb::" << result_type << " > r (" << endl
          << "new (shared) " << db << "::" << result_type << " (" << endl
-         << "q, st, sts, " << (versioned ? "&svm" : "0") << "));"
+         << "q, st, sts, " << (versioned ? "&svm" : "0") <<
+        (poly_join ? ", polymorphic_join_columns" : "") << "));"
          << endl
          << "return result<object_type> (r);"
          << "}";
@@ -4238,6 +4451,35 @@ traverse_object (type& c)
            << "{"
            << "return query (db, query_base_type (q));"
            << "}";
+
+      // find (ids)
+      //
+      // Select the objects with the id IN (...) condition and let the
+      // result do the loading.
+      //
+      if (generate_load_many &&
+          id != 0 && !poly && !abst && !composite_wrapper (utype (*id)))
+      {
+        instance<object_columns_list> id_cols;
+        id_cols->traverse (*id);
+        object_columns_list::iterator i (id_cols->begin ());
+
+        string const& conv (convert_to_expr (i->type, *i->member));
+
+        os << "result< " << traits << "::object_type >" << endl
+           << traits << "::" << endl
+           << "find (database& db, const id_type** ids, std::size_t n)"
+           << "{"
+           << "return query (" << endl
+           << "db," << endl
+           << db << "::object_id_in<object_type> (" << endl
+           << strlit (qtable) << "," << endl
+           << strlit (quote_id (i->name)) << "," << endl
+           << (conv.empty () ? "0" : strlit (conv)) << "," << endl
+           << "ids," << endl
+           << "n));"
+           << "}";
+      }
     }
 
     // erase_query
@@ -4436,7 +4678,8 @@ traverse_object (type& c)
       os << endl
          << "return shared_ptr<result_impl> (" << endl
          << "new (shared) " << db << "::" << result_type << " (" << endl
-         << "pq.query, st, sts, " << (versioned ? "&svm" : "0") << "));"
+         << "pq.query, st, sts, " << (versioned ? "&svm" : "0") <<
+        (poly_join ? ", polymorphic_join_columns" : "") << "));"
          << "}";
     }
   }
@@ -5568,7 +5811,7 @@ traverse_view (type& c)
 
     os << "qs.init_parameters ();"
        << "shared_ptr<select_statement> st (" << endl
-       << "new (shared) select_statement (" << endl;
+       << query_statement_ctor (c) << " (" << endl;
     view_query_statement_ctor_args (
       c, "qs", versioned || query_optimize, false);
     os << "));" << endl
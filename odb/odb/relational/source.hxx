@@ -3594,6 +3594,12 @@ namespace relational
             }
           }
 
+          // Batch load (see the batch-load processor logic).
+          //
+          bool batch (!base && !inverse && !versioned &&
+                      c_.count ("batch-load"));
+          statement_columns batch_sc;
+
           // select_statement
           //
           os << "const char " << scope << "::" << endl
@@ -3731,6 +3737,9 @@ namespace relational
 
             process_statement_columns (sc, statement_select, versioned);
 
+            if (batch)
+              batch_sc = sc;
+
             os << strlit ("SELECT" + sep) << endl;
 
             for (statement_columns::const_iterator i (sc.begin ()),
@@ -3770,6 +3779,56 @@ namespace relational
           os << ";"
              << endl;
 
+          // batch_select_statement
+          //
+          // Same as select_statement but for several objects at once. The
+          // object id is selected first so that the rows can be matched
+          // to objects and the rows are ordered by it.
+          //
+          if (batch)
+          {
+            os << "const char " << scope << "::" << endl
+               << "batch_select_statement[] =" << endl;
+
+            // Simple id is guaranteed by the processor.
+            //
+            object_columns_list::iterator id (id_cols->begin ());
+            string idc (qtable + "." + quote_id (id->name));
+
+            os << strlit ("SELECT" + sep) << endl
+               << strlit (convert_from (idc, id->type, *id->member) + "," +
+                          sep) << endl;
+
+            for (statement_columns::const_iterator i (batch_sc.begin ()),
+                   e (batch_sc.end ()); i != e;)
+            {
+              string const& c (i->column);
+              os << strlit (c + (++i != e ? "," : "") + sep) << endl;
+            }
+
+            os << strlit ("FROM " + qtable + sep) << endl;
+
+            instance<query_parameters> qp (statement_select, table);
+            unsigned long long n (c_.get<unsigned long long> ("batch-load"));
+
+            string where ("WHERE " + idc + " IN (");
+            for (unsigned long long i (0); i != n; ++i)
+            {
+              if (i != 0)
+                where += ',';
+
+              where += convert_to (qp->next (*id), id->type, *id->member);
+            }
+            where += ") ORDER BY " + idc;
+
+            if (ordered)
+              where += "," + sep + qtable + "." +
+                column_qname (m, "index", "index", column_prefix ());
+
+            os << strlit (where) << ";"
+               << endl;
+          }
+
           // insert_statement
           //
           os << "const char " << scope << "::" << endl
@@ -4872,9 +4931,18 @@ namespace relational
            << "}"
           // We use the id binding directly so no need to check cond binding.
           //
-           << "select_statement& st (sts.select_statement ());"
-           << "st.execute ();"
-           << "auto_result ar (st);";
+           << "select_statement& st (";
+
+        // With batch loading the elements of several objects are fetched
+        // at once (see the batch-load processor logic).
+        //
+        if (!base && !inverse && !versioned && c_.count ("batch-load"))
+          os << "sts.load_statement (batch_select_statement));";
+        else
+          os << "sts.select_statement ());"
+             << "st.execute ();";
+
+        os << "auto_result ar (st);";
 
         // If we are loading eager object pointers, we may need to cache
         // the result since we will be loading other objects.
@@ -6720,6 +6788,15 @@ namespace relational
       {
       }
 
+      // Number of result columns produced by a (processed) SELECT
+      // statement column.
+      //
+      virtual size_t
+      statement_column_width (statement_column const&)
+      {
+        return 1;
+      }
+
       //
       // object
       //
@@ -6731,6 +6808,16 @@ namespace relational
       extra_statement_cache_extra_args (bool /*containers*/,
                                         bool /*sections*/) {}
 
+      // Expression that creates the select statement for a dynamic
+      // (non-prepared) query. It is followed by the query statement
+      // constructor arguments and should yield shared_ptr<select_statement>.
+      //
+      virtual string
+      query_statement_ctor (type&)
+      {
+        return "new (shared) select_statement";
+      }
+
       virtual void
       object_query_statement_ctor_args (type&,
                                         std::string const& q,
@@ -108,9 +108,17 @@ namespace relational
     }
 
     void member_image_type::
-    traverse_string (member_info&)
+    traverse_text (member_info& mi)
     {
-      type_ = "details::buffer";
+      type_ = "sqlite::image_traits< " + mi.fq_type () +
+        ", sqlite::id_text >::image_type";
+    }
+
+    void member_image_type::
+    traverse_blob (member_info& mi)
+    {
+      type_ = "sqlite::image_traits< " + mi.fq_type () +
+        ", sqlite::id_blob >::image_type";
     }
 
     void member_image_type::
@@ -96,7 +96,10 @@ namespace relational
       traverse_real (member_info&);
 
       virtual void
-      traverse_string (member_info&);
+      traverse_text (member_info&);
+
+      virtual void
+      traverse_blob (member_info&);
 
       virtual void
       traverse_stream (member_info&);
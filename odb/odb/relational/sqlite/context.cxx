@@ -54,6 +54,7 @@ namespace relational
         {"double", "REAL", 0, true},
 
         {"::std::string", "TEXT", 0, false},
+        {"::std::string_view", "TEXT", 0, false},
         {"::std::wstring", "TEXT", 0, false}
       };
     }
@@ -85,7 +86,11 @@ namespace relational
       insert_send_auto_id = true;
       delay_freeing_statement_result = false;
       need_image_clone = false;
-      generate_bulk = false;
+      generate_bulk = true;
+      generate_batch_load = true;
+      generate_dirty_tracking = true;
+      generate_load_many = true;
+      generate_polymorphic_join = true;
       global_index = true;
       global_fkey = false;
       data_->bind_vector_ = "sqlite::bind*";
@@ -242,6 +247,37 @@ namespace relational
       return r;
     }
 
+    bool context::
+    upsert (semantics::class_& c)
+    {
+      // The upsert statement is bound to the update image binding (the
+      // update columns followed by the id and the version) so we can only
+      // handle objects where these columns are all the columns that are
+      // inserted. We also don't handle sections and readonly containers
+      // (they are only persisted, never updated).
+      //
+      if (id_member (c) == 0 ||
+          abstract (c) ||
+          polymorphic (c) != 0 ||
+          readonly (c) ||
+          versioned (c))
+        return false;
+
+      column_count_type const& cc (column_count (c));
+
+      if (cc.readonly != 0 || cc.separate_update != 0)
+        return false;
+
+      user_sections& uss (c.get<user_sections> ("user-sections"));
+
+      if (uss.count (user_sections::count_total |
+                     user_sections::count_all) != 0)
+        return false;
+
+      return has_a (c, test_straight_container) ==
+        has_a (c, test_readwrite_container, &main_section);
+    }
+
     string context::
     database_type_impl (semantics::type& t,
                         semantics::names* hint,
@@ -62,6 +62,13 @@ namespace relational
       static sql_type
       parse_sql_type (string const&, custom_db_types const* = 0);
 
+    public:
+      // Return true if the upsert (INSERT ... ON CONFLICT DO UPDATE)
+      // statement and function should be generated for this object.
+      //
+      bool
+      upsert (semantics::class_&);
+
     protected:
       virtual string const&
       convert_expr (string const&, semantics::data_member&, bool);
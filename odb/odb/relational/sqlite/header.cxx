@@ -14,6 +14,67 @@ namespace relational
     {
       namespace relational = relational::header;
 
+      struct class1: relational::class1, context
+      {
+        class1 (base const& x): base (x) {}
+
+        virtual void
+        object_public_extra_post (type& c)
+        {
+          bool abst (abstract (c));
+
+          type* poly_root (polymorphic (c));
+          bool poly (poly_root != 0);
+          bool poly_derived (poly && poly_root != &c);
+
+          if (poly_derived || (abst && !poly))
+            return;
+
+          // Bulk operations batch size. SQLite has no array parameters and
+          // executes the batch by stepping the same prepared statement for
+          // each object, so the batch size only affects the number of
+          // images kept in the statements cache.
+          //
+          {
+            unsigned long long b (c.count ("bulk")
+                                  ? c.get<unsigned long long> ("bulk")
+                                  : 1);
+
+            os << "static const std::size_t batch = " << b << "UL;"
+               << endl;
+          }
+
+          // Number of objects whose containers are loaded at once while
+          // iterating over a query result or 0 if batch loading is not
+          // used (see --generate-batch-load).
+          //
+          {
+            unsigned long long b (c.count ("batch-load")
+                                  ? c.get<unsigned long long> ("batch-load")
+                                  : 0);
+
+            os << "static const std::size_t batch_load = " << b << "UL;"
+               << endl;
+          }
+
+          // Dirty tracking (only update the changed columns).
+          //
+          os << "static const bool dirty_tracking = " <<
+            c.count ("dirty-tracking") << ";"
+             << endl;
+
+          // Upsert (persist or update with a single statement).
+          //
+          if (upsert (c))
+            os << "static const char upsert_statement[];"
+               << endl
+               << "static void" << endl
+               << "upsert (database&, const object_type&);"
+               << endl;
+        }
+      };
+      entry<class1> class1_entry_;
+
       struct image_member: relational::image_member_impl<sql_type>,
                            member_base
       {
@@ -119,7 +119,8 @@ namespace relational
           os << b << ".type = sqlite::image_traits<" << endl
              << "  " << mi.fq_type () << "," << endl
              << "  sqlite::id_text>::bind_value;"
-             << b << ".buffer = " << arg << "." << mi.var << "value.data ();"
+             << b << ".buffer = " << arg << "." << mi.var <<
+            "value.data_ptr ();"
              << b << ".size = &" << arg << "." << mi.var << "size;"
              << b << ".capacity = " << arg << "." << mi.var <<
             "value.capacity ();"
@@ -129,8 +130,11 @@ namespace relational
         virtual void
         traverse_blob (member_info& mi)
         {
-          os << b << ".type = sqlite::bind::blob;"
-             << b << ".buffer = " << arg << "." << mi.var << "value.data ();"
+          os << b << ".type = sqlite::image_traits<" << endl
+             << "  " << mi.fq_type () << "," << endl
+             << "  sqlite::id_blob>::bind_value;"
+             << b << ".buffer = " << arg << "." << mi.var <<
+            "value.data_ptr ();"
              << b << ".size = &" << arg << "." << mi.var << "size;"
              << b << ".capacity = " << arg << "." << mi.var <<
             "value.capacity ();"
@@ -457,6 +461,54 @@ namespace relational
           return base::join_syntax (vo);
         }
 
+        // Dynamic query statements are looked up in the per-connection
+        // statement cache so that repeated queries of the same shape
+        // reuse the prepared statement.
+        //
+        virtual string
+        query_statement_ctor (type&)
+        {
+          return "conn.statement_cache ().find_query";
+        }
+
+        virtual void
+        object_query_statement_ctor_args (type& c,
+                                          string const& q,
+                                          bool process,
+                                          bool prepared)
+        {
+          if (prepared)
+          {
+            base::object_query_statement_ctor_args (c, q, process, prepared);
+            return;
+          }
+
+          os << "text," << endl
+             << process << "," << endl // Process.
+             << "true," << endl        // Optimize.
+             << q << ".parameters_binding ()," << endl
+             << "imb";
+        }
+
+        virtual void
+        view_query_statement_ctor_args (type& c,
+                                        string const& q,
+                                        bool process,
+                                        bool prepared)
+        {
+          if (prepared)
+          {
+            base::view_query_statement_ctor_args (c, q, process, prepared);
+            return;
+          }
+
+          os << q << ".clause ()," << endl
+             << process << "," << endl   // Process.
+             << "true," << endl          // Optimize.
+             << q << ".parameters_binding ()," << endl
+             << "imb";
+        }
+
         virtual void
         process_statement_columns (relational::statement_columns& cols,
                                    statement_kind sk,
@@ -464,6 +516,289 @@ namespace relational
         {
           statement_columns_common::process (cols, sk);
         }
+
+        virtual size_t
+        statement_column_width (relational::statement_column const& c)
+        {
+          // Stream columns are followed by _ROWID_ (see above).
+          //
+          return parse_sql_type (c.type, *c.member).stream ? 2 : 1;
+        }
+
+        virtual void
+        traverse_object (type& c)
+        {
+          base::traverse_object (c);
+
+          if (upsert (c))
+            traverse_upsert (c);
+        }
+
+        // Generate the upsert statement and function. The statement is
+        // INSERT ... ON CONFLICT DO UPDATE that uses numbered parameters
+        // to reuse the update image binding (update columns followed by
+        // the id and the version). The version parameter is used twice:
+        // it is incremented in the inserted row and compared in the
+        // WHERE clause of the update.
+        //
+        void
+        traverse_upsert (type& c)
+        {
+          using semantics::data_member;
+
+          data_member_path* id (id_member (c));
+          data_member* opt (optimistic (c));
+          bool dirty (c.count ("dirty-tracking") != 0);
+
+          string traits ("access::object_traits_impl< " +
+                         class_fq_name (c) + ", id_sqlite >");
+
+          qname table (table_name (c));
+          string qtable (quote_id (table));
+
+          relational::statement_columns sc;
+          {
+            relational::query_parameters* p (0); // Imperfect forwarding.
+            statement_kind sk (statement_update); // Imperfect forwarding.
+            object_section* s (&main_section); // Imperfect forwarding.
+            instance<relational::object_columns> t (sk, sc, p, s);
+            t->traverse (c);
+          }
+
+          instance<object_columns_list> id_cols;
+          id_cols->traverse (*id);
+
+          instance<relational::query_parameters> qp (statement_update, table);
+
+          size_t n (0);
+          strings cols, params, sets;
+
+          for (relational::statement_columns::const_iterator i (sc.begin ());
+               i != sc.end (); ++i)
+          {
+            // The version column is bound after the id (see below).
+            //
+            if (version (*i->member))
+              continue;
+
+            // Stream columns keep their named parameter (see
+            // query_parameters above) which SQLite numbers in the
+            // order of appearance.
+            //
+            string p (qp->next (*i->member, i->column, i->type));
+
+            if (p == "?")
+            {
+              ostringstream o;
+              o << '?' << n + 1;
+              p = o.str ();
+            }
+
+            n++;
+
+            cols.push_back (i->column);
+            params.push_back (convert_to (p, i->type, *i->member));
+            sets.push_back (i->column + "=excluded." + i->column);
+          }
+
+          string conflict;
+          for (object_columns_list::iterator b (id_cols->begin ()), i (b);
+               i != id_cols->end (); ++i)
+          {
+            ostringstream p;
+            p << '?' << ++n;
+
+            string name (quote_id (i->name));
+
+            cols.push_back (name);
+            params.push_back (convert_to (p.str (), i->type, *i->member));
+            conflict += (i != b ? "," : "") + name;
+          }
+
+          string where;
+          if (opt != 0)
+          {
+            ostringstream p;
+            p << '?' << ++n;
+
+            string name (column_qname (*opt, column_prefix ()));
+            string type (column_type (*opt));
+            string v (convert_to (p.str (), type, *opt));
+
+            cols.push_back (name);
+            params.push_back (v + "+1");
+            sets.push_back (name + "=excluded." + name);
+            where = "WHERE " + qtable + "." + name + "=" + v;
+          }
+
+          os << "const char " << traits << "::upsert_statement[] =" << endl
+             << strlit ("INSERT INTO " + qtable + " ") << endl;
+
+          for (strings::const_iterator b (cols.begin ()), i (b);
+               i != cols.end ();)
+          {
+            string s (i == b ? "(" : "");
+            s += *i;
+            s += (++i != cols.end () ? ',' : ')');
+            os << strlit (s + " ") << endl;
+          }
+
+          os << strlit ("VALUES ") << endl;
+
+          for (strings::const_iterator b (params.begin ()), i (b);
+               i != params.end ();)
+          {
+            string s (i == b ? "(" : "");
+            s += *i;
+            s += (++i != params.end () ? ',' : ')');
+            os << strlit (s + " ") << endl;
+          }
+
+          os << strlit ("ON CONFLICT (" + conflict + ") ") << endl;
+
+          if (sets.empty ())
+            os << strlit ("DO NOTHING");
+          else
+          {
+            os << strlit ("DO UPDATE SET ") << endl;
+
+            for (strings::const_iterator i (sets.begin ()); i != sets.end ();)
+            {
+              string s (*i);
+              bool last (++i == sets.end ());
+
+              if (!last)
+                s += ',';
+
+              if (!last || !where.empty ())
+                s += ' ';
+
+              os << strlit (s);
+
+              if (!last || !where.empty ())
+                os << endl;
+            }
+
+            if (!where.empty ())
+              os << strlit (where);
+          }
+
+          os << ";"
+             << endl;
+
+          // upsert ()
+          //
+          os << "void " << traits << "::" << endl
+             << "upsert (database& db, const object_type& obj)"
+             << "{"
+             << "ODB_POTENTIALLY_UNUSED (db);"
+             << endl
+             << "using namespace sqlite;"
+             << "using sqlite::update_statement;"
+             << endl
+             << "callback (db, obj, callback_event::pre_update);"
+             << endl
+             << "sqlite::transaction& tr (sqlite::transaction::current ());"
+             << "sqlite::connection& conn (tr.connection (db));"
+             << "statements_type& sts (" << endl
+             << "conn.statement_cache ().find_object<object_type> ());"
+             << endl;
+
+          // Initialize id and object images the same way as update().
+          //
+          if (opt != 0)
+            os << "const version_type& v (version (obj));";
+
+          os << "id_image_type& idi (sts.id_image ());"
+             << "init (idi, id (obj)" << (opt != 0 ? ", &v" : "") << ");"
+             << endl;
+
+          os << "image_type& im (sts.image ());";
+
+          if (generate_grow)
+            os << "if (";
+
+          os << "init (im, obj, statement_update)";
+
+          if (generate_grow)
+            os << ")" << endl
+               << "im.version++";
+
+          os << ";"
+             << endl;
+
+          os << "bool u (false);"
+             << "binding& imb (sts.update_image_binding ());"
+             << "if (im.version != sts.update_image_version () ||" << endl
+             << "imb.version == 0)"
+             << "{"
+             << "bind (imb.bind, im, statement_update);"
+             << "sts.update_image_version (im.version);"
+             << "imb.version++;"
+             << "u = true;"
+             << "}";
+
+          os << "binding& idb (sts.id_image_binding ());"
+             << "if (idi.version != sts.update_id_image_version () ||" << endl
+             << "idb.version == 0)"
+             << "{"
+             << "if (idi.version != sts.id_image_version () ||" << endl
+             << "idb.version == 0)"
+             << "{"
+             << "bind (idb.bind, idi);"
+             << "sts.id_image_version (idi.version);"
+             << "idb.version++;";
+          if (opt != 0)
+            os << "sts.optimistic_id_image_binding ().version++;";
+          os << "}"
+             << "sts.update_id_image_version (idi.version);"
+             << endl
+             << "if (!u)" << endl
+             << "imb.version++;"
+             << "}";
+
+          // If the row exists but its version does not match, then the
+          // update is skipped by the WHERE clause and nothing changes.
+          //
+          if (opt != 0)
+            os << "if (sts.upsert_statement ().execute () == 0)" << endl
+               << "throw object_changed ();"
+               << endl;
+          else
+            os << "sts.upsert_statement ().execute ();"
+               << endl;
+
+          // Containers are updated by deleting and re-inserting their
+          // elements, which also works for a newly inserted object.
+          //
+          if (has_a (c, test_readwrite_container, &main_section))
+          {
+            os << "extra_statement_cache_type& esc (" <<
+              "sts.extra_statement_cache ());"
+               << endl;
+
+            instance<relational::container_calls> t (
+              relational::container_calls::update_call, &main_section);
+            t->traverse (c);
+          }
+
+          if (opt != 0)
+          {
+            inc_member (*opt,
+                        "const_cast<object_type&> (obj)",
+                        "obj",
+                        "version_type");
+            os << endl;
+          }
+
+          if (dirty)
+            os << "sts.dirty_snapshot (id (obj), obj, 0, true);"
+               << endl;
+
+          os << "callback (db, obj, callback_event::post_update);"
+             << "pointer_cache_traits::update (db, obj);"
+             << "}";
+        }
       };
       entry<class_> class_entry_;
     }
@@ -434,6 +434,26 @@ namespace relational
           c.set ("bulk-erase", true);
         }
 
+        // Validate dirty tracking support.
+        //
+        if (c.count ("dirty-tracking"))
+        {
+          location_t l (c.get<location_t> ("dirty-tracking-location"));
+
+          if (polymorphic (c))
+          {
+            error (l) << "dirty tracking of polymorphic objects is not "
+              "supported" << endl;
+            valid_ = false;
+          }
+          else if (c.count ("bulk"))
+          {
+            error (l) << "dirty tracking of objects with bulk operations "
+              "is not supported" << endl;
+            valid_ = false;
+          }
+        }
+
         // Validate indexes.
         //
         {